@@ -0,0 +1,429 @@
+#include <array>
+#include <bit>
+#include <cstdint>
+#include "types.h"
+#include "utils.h"
+#include "attacks.h"
+
+
+// Fills the entries of the squares from the first square up to but not
+// including the last square in the PEXT attack table of a slider. For each
+// square, the attacks of every subset of its mask are stored in the order the
+// subsets come in when counting up, which is the same order as the values
+// PEXT extracts from them.
+template <std::size_t table_size>
+constexpr std::array<Bitboard, table_size> gen_pext_table(
+        const std::array<std::array<Bitboard, 64>, 4> &rays,
+        const std::array<Bitboard, 64> &masks,
+        const std::array<unsigned, 64> &offsets,
+        const int first_square,
+        const int last_square,
+        std::array<Bitboard, table_size> table
+)
+{
+    for (auto square_index = first_square; square_index < last_square;
+         square_index++)
+    {
+        const std::array<Bitboard, 4> square_rays =
+        {
+            rays[0][square_index], rays[1][square_index],
+            rays[2][square_index], rays[3][square_index]
+        };
+        const Bitboard mask = masks[square_index];
+        Bitboard *entry = table.data() + offsets[square_index];
+        Bitboard occupancy = 0;
+
+        do
+        {
+            *entry++ = slider_attacks(square_rays, occupancy);
+            occupancy = (occupancy - mask) & mask;
+        } while (occupancy != 0);
+    }
+
+    return table;
+}
+
+
+// Generates the magic attack table of a slider by moving the attacks of each
+// subset from its PEXT index to its magic index. Compilation fails if two
+// subsets with different attacks get the same magic index.
+template <std::size_t table_size>
+constexpr std::array<Bitboard, table_size> gen_magic_table(
+        const std::array<Bitboard, table_size> &pext_table,
+        const std::array<Bitboard, 64> &masks,
+        const std::array<unsigned, 64> &offsets,
+        const std::array<Bitboard, 64> &magics,
+        const std::array<unsigned, 64> &shifts
+)
+{
+    std::array<Bitboard, table_size> table = {};
+
+    for (auto square_index = 0; square_index < 64; square_index++)
+    {
+        const Bitboard mask = masks[square_index];
+        const Bitboard magic = magics[square_index];
+        const unsigned shift = shifts[square_index];
+        const Bitboard *pext_entry = pext_table.data() +
+                                     offsets[square_index];
+        Bitboard *const square_table = table.data() + offsets[square_index];
+        Bitboard occupancy = 0;
+
+        do
+        {
+            Bitboard &entry = square_table[(occupancy * magic) >> shift];
+
+            // A slider always attacks at least one square, so an entry that
+            // is 0 has not been filled yet.
+            if (entry != 0 && entry != *pext_entry)
+            {
+                throw "Two occupancies with different attacks share a magic "
+                      "index.";
+            }
+
+            entry = *pext_entry++;
+            occupancy = (occupancy - mask) & mask;
+        } while (occupancy != 0);
+    }
+
+    return table;
+}
+
+
+// Generates the distinct attack sets of a slider on every square. The
+// attack sets of a square are numbered by the number of squares attacked on
+// each ray, with the first ray as the most significant digit.
+template <std::size_t distinct_size>
+constexpr std::array<Bitboard, distinct_size> gen_distinct_attacks(
+        const std::array<std::array<Bitboard, 64>, 4> &rays,
+        const std::array<unsigned, 64> &counts,
+        const std::array<unsigned, 64> &offsets
+)
+{
+    std::array<Bitboard, distinct_size> distinct_attacks = {};
+
+    for (auto square_index = 0; square_index < 64; square_index++)
+    {
+        for (unsigned number = 0; number < counts[square_index]; number++)
+        {
+            Bitboard attacks = 0;
+            unsigned remaining_number = number;
+
+            // Go through the digits from the least significant one.
+            for (auto direction = 3; direction >= 0; direction--)
+            {
+                Bitboard ray = rays[direction][square_index];
+                const unsigned length = std::popcount(ray);
+
+                if (length == 0)
+                {
+                    continue;
+                }
+
+                // Remove the squares behind the last attacked square. They
+                // are the most significant squares of the rays going
+                // towards higher squares and the least significant squares
+                // otherwise.
+                for (unsigned removed = remaining_number % length + 1;
+                     removed < length; removed++)
+                {
+                    ray ^= direction < 2 ? std::bit_floor(ray) : ray & -ray;
+                }
+
+                attacks |= ray;
+                remaining_number /= length;
+            }
+
+            distinct_attacks[offsets[square_index] + number] = attacks;
+        }
+    }
+
+    return distinct_attacks;
+}
+
+
+// Fills the entries of the squares from the first square up to but not
+// including the last square in the compact version of an attack table of a
+// slider. Each entry is replaced by the index of its attacks in the distinct
+// attack array.
+template <std::size_t table_size>
+constexpr std::array<std::uint16_t, table_size> gen_compact_table(
+        const std::array<Bitboard, table_size> &table,
+        const std::array<std::array<Bitboard, 64>, 4> &rays,
+        const std::array<Bitboard, 64> &masks,
+        const std::array<unsigned, 64> &offsets,
+        const std::array<unsigned, 64> &distinct_offsets,
+        const int first_square,
+        const int last_square,
+        std::array<std::uint16_t, table_size> compact_table
+)
+{
+    for (auto square_index = first_square; square_index < last_square;
+         square_index++)
+    {
+        const unsigned first_entry = offsets[square_index];
+        const unsigned last_entry = first_entry +
+                                    (1u << std::popcount(masks[square_index]));
+
+        for (auto entry = first_entry; entry < last_entry; entry++)
+        {
+            // Number the attacks the same way gen_distinct_attacks() does.
+            unsigned number = 0;
+
+            for (const auto &direction_rays : rays)
+            {
+                const Bitboard ray = direction_rays[square_index];
+
+                if (ray != 0)
+                {
+                    number = number * std::popcount(ray) +
+                             std::popcount(table[entry] & ray) - 1;
+                }
+            }
+
+            compact_table[entry] = distinct_offsets[square_index] + number;
+        }
+    }
+
+    return compact_table;
+}
+
+
+// The full attack tables. In the compact layout, they are only used to
+// generate the compact tables.
+constexpr std::array<Bitboard, bishop_table_size> full_pext_bishop_table =
+        gen_pext_table<bishop_table_size>(
+                bishop_rays,
+                bishop_masks,
+                bishop_offsets,
+                0,
+                64,
+                {}
+        );
+
+// The rook table is generated in two halves because generating it at once
+// takes more steps than GCC allows in one constant expression.
+constexpr std::array<Bitboard, rook_table_size> full_pext_rook_table_half =
+        gen_pext_table<rook_table_size>(
+                rook_rays,
+                rook_masks,
+                rook_offsets,
+                0,
+                32,
+                {}
+        );
+constexpr std::array<Bitboard, rook_table_size> full_pext_rook_table =
+        gen_pext_table<rook_table_size>(
+                rook_rays,
+                rook_masks,
+                rook_offsets,
+                32,
+                64,
+                full_pext_rook_table_half
+        );
+
+constexpr std::array<Bitboard, bishop_table_size> full_magic_bishop_table =
+        gen_magic_table(
+                full_pext_bishop_table,
+                bishop_masks,
+                bishop_offsets,
+                bishop_magics,
+                bishop_shifts
+        );
+constexpr std::array<Bitboard, rook_table_size> full_magic_rook_table =
+        gen_magic_table(
+                full_pext_rook_table,
+                rook_masks,
+                rook_offsets,
+                rook_magics,
+                rook_shifts
+        );
+
+#ifdef COMPACT_SLIDER_ATTACKS
+constexpr std::array<Bitboard, bishop_distinct_size> bishop_distinct_attacks =
+        gen_distinct_attacks<bishop_distinct_size>(
+                bishop_rays,
+                bishop_distinct_counts,
+                bishop_distinct_offsets
+        );
+constexpr std::array<Bitboard, rook_distinct_size> rook_distinct_attacks =
+        gen_distinct_attacks<rook_distinct_size>(
+                rook_rays,
+                rook_distinct_counts,
+                rook_distinct_offsets
+        );
+
+constexpr std::array<Slider_entry, bishop_table_size> magic_bishop_table =
+        gen_compact_table<bishop_table_size>(
+                full_magic_bishop_table,
+                bishop_rays,
+                bishop_masks,
+                bishop_offsets,
+                bishop_distinct_offsets,
+                0,
+                64,
+                {}
+        );
+constexpr std::array<Slider_entry, bishop_table_size> pext_bishop_table =
+        gen_compact_table<bishop_table_size>(
+                full_pext_bishop_table,
+                bishop_rays,
+                bishop_masks,
+                bishop_offsets,
+                bishop_distinct_offsets,
+                0,
+                64,
+                {}
+        );
+
+// The compact rook tables are also generated in two halves.
+constexpr std::array<Slider_entry, rook_table_size> magic_rook_table_half =
+        gen_compact_table<rook_table_size>(
+                full_magic_rook_table,
+                rook_rays,
+                rook_masks,
+                rook_offsets,
+                rook_distinct_offsets,
+                0,
+                32,
+                {}
+        );
+constexpr std::array<Slider_entry, rook_table_size> magic_rook_table =
+        gen_compact_table<rook_table_size>(
+                full_magic_rook_table,
+                rook_rays,
+                rook_masks,
+                rook_offsets,
+                rook_distinct_offsets,
+                32,
+                64,
+                magic_rook_table_half
+        );
+constexpr std::array<Slider_entry, rook_table_size> pext_rook_table_half =
+        gen_compact_table<rook_table_size>(
+                full_pext_rook_table,
+                rook_rays,
+                rook_masks,
+                rook_offsets,
+                rook_distinct_offsets,
+                0,
+                32,
+                {}
+        );
+constexpr std::array<Slider_entry, rook_table_size> pext_rook_table =
+        gen_compact_table<rook_table_size>(
+                full_pext_rook_table,
+                rook_rays,
+                rook_masks,
+                rook_offsets,
+                rook_distinct_offsets,
+                32,
+                64,
+                pext_rook_table_half
+        );
+#else
+constexpr std::array<Slider_entry, bishop_table_size> magic_bishop_table =
+        full_magic_bishop_table;
+constexpr std::array<Slider_entry, rook_table_size> magic_rook_table =
+        full_magic_rook_table;
+constexpr std::array<Slider_entry, bishop_table_size> pext_bishop_table =
+        full_pext_bishop_table;
+constexpr std::array<Slider_entry, rook_table_size> pext_rook_table =
+        full_pext_rook_table;
+#endif
+
+
+// Checks if the CPU supports the PEXT instruction.
+bool pext_supported()
+{
+#ifdef PEXT_SUPPORTED
+    __builtin_cpu_init();
+
+    return __builtin_cpu_supports("bmi2");
+#else
+    return false;
+#endif
+}
+
+
+// Checks if the CPU has a fast PEXT instruction. AMD CPUs before Zen 3
+// support BMI2 but run PEXT in microcode, which is slower than a magic
+// lookup.
+bool fast_pext_supported()
+{
+#ifdef PEXT_SUPPORTED
+    return pext_supported() && !__builtin_cpu_is("znver1") &&
+           !__builtin_cpu_is("znver2");
+#else
+    return false;
+#endif
+}
+
+
+// The tables need no initialization, so the backend can be chosen before
+// main() runs.
+Slider_backend slider_backend = fast_pext_supported() ? Slider_backend::pext :
+                                                        Slider_backend::magic;
+
+
+// Makes bishop_attacks() and rook_attacks() use the specified backend.
+// Returns false and keeps the current backend if the CPU does not support
+// it.
+bool set_slider_backend(const Slider_backend backend)
+{
+    if (backend == Slider_backend::pext && !pext_supported())
+    {
+        return false;
+    }
+
+    slider_backend = backend;
+    return true;
+}
+
+
+// Returns the squares strictly between two squares that share a row, column
+// or diagonal. Returns an empty bitboard if they do not share one.
+Bitboard squares_between(const Square square1, const Square square2)
+{
+    const Bitboard square1_bb = square_to_bb(square1);
+    const Bitboard square2_bb = square_to_bb(square2);
+
+    // With only the other square as a blocker, the attacks from both squares
+    // along their shared line overlap exactly on the squares between them.
+    if (on_bitboard(rook_attacks(square1, 0), square2_bb))
+    {
+        return rook_attacks(square1, square2_bb) &
+               rook_attacks(square2, square1_bb);
+    }
+    if (on_bitboard(bishop_attacks(square1, 0), square2_bb))
+    {
+        return bishop_attacks(square1, square2_bb) &
+               bishop_attacks(square2, square1_bb);
+    }
+
+    return 0;
+}
+
+
+// Returns all the squares of the row, column or diagonal that goes through
+// both squares, including the two squares themselves. Returns an empty
+// bitboard if they do not share one.
+Bitboard line_through(const Square square1, const Square square2)
+{
+    const Bitboard both_squares = square_to_bb(square1) |
+                                  square_to_bb(square2);
+
+    // On an empty board, the attacks from both squares only overlap on the
+    // line they share.
+    if (on_bitboard(rook_attacks(square1, 0), square_to_bb(square2)))
+    {
+        return (rook_attacks(square1, 0) & rook_attacks(square2, 0)) |
+               both_squares;
+    }
+    if (on_bitboard(bishop_attacks(square1, 0), square_to_bb(square2)))
+    {
+        return (bishop_attacks(square1, 0) & bishop_attacks(square2, 0)) |
+               both_squares;
+    }
+
+    return 0;
+}
@@ -0,0 +1,535 @@
+#ifndef DISCORD_CHESS_BOT_ATTACKS_H
+#define DISCORD_CHESS_BOT_ATTACKS_H
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include "types.h"
+
+// PEXT can only be used on x86-64 with a compiler that supports GNU inline
+// assembly.
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define PEXT_SUPPORTED
+#endif
+
+
+// Generates an attack bitboard for every square using a list of
+// (row, column) offsets for pieces that move a fixed distance.
+template <std::size_t size>
+constexpr std::array<Bitboard, 64> gen_leaper_attacks(
+        const std::array<std::array<int, 2>, size> &offsets
+)
+{
+    std::array<Bitboard, 64> attacks = {};
+
+    for (auto square_index = 0; square_index < 64; square_index++)
+    {
+        const int row = square_index / 8;
+        const int col = square_index % 8;
+
+        // Add every destination square that is within the boundaries of
+        // the board.
+        for (const auto &offset : offsets)
+        {
+            const int dest_row = row + offset[0];
+            const int dest_col = col + offset[1];
+
+            if (dest_row >= 0 && dest_row < 8 &&
+                dest_col >= 0 && dest_col < 8)
+            {
+                attacks[square_index] |= static_cast<Bitboard>(1)
+                                         << (dest_row * 8 + dest_col);
+            }
+        }
+    }
+
+    return attacks;
+}
+
+// Squares attacked by a knight on each square.
+constexpr std::array<Bitboard, 64> knight_attacks = gen_leaper_attacks<8>(
+{{
+    {2, 1}, {2, -1}, {1, 2}, {1, -2},
+    {-2, 1}, {-2, -1}, {-1, 2}, {-1, -2}
+}});
+
+// Squares attacked by a king on each square.
+constexpr std::array<Bitboard, 64> king_attacks = gen_leaper_attacks<8>(
+{{
+    {1, 0}, {1, 1}, {0, 1}, {-1, 1},
+    {-1, 0}, {-1, -1}, {0, -1}, {1, -1}
+}});
+
+// Squares attacked by a white pawn on each square.
+constexpr std::array<Bitboard, 64> w_pawn_attacks = gen_leaper_attacks<2>(
+{{
+    {1, 1}, {1, -1}
+}});
+
+// Squares attacked by a black pawn on each square.
+constexpr std::array<Bitboard, 64> b_pawn_attacks = gen_leaper_attacks<2>(
+{{
+    {-1, 1}, {-1, -1}
+}});
+
+// The (row, column) steps of the directions a bishop and a rook move in. The
+// first two directions of each piece go towards higher squares and the last
+// two go towards lower squares.
+constexpr std::array<std::array<int, 2>, 4> bishop_directions =
+{{
+    {1, 1}, {1, -1}, {-1, 1}, {-1, -1}
+}};
+constexpr std::array<std::array<int, 2>, 4> rook_directions =
+{{
+    {1, 0}, {0, 1}, {-1, 0}, {0, -1}
+}};
+
+// Generates, for each direction and square, the squares from that square to
+// the edge of the board, not including the square itself.
+constexpr std::array<std::array<Bitboard, 64>, 4> gen_rays(
+        const std::array<std::array<int, 2>, 4> &directions
+)
+{
+    std::array<std::array<Bitboard, 64>, 4> rays = {};
+
+    for (auto direction = 0; direction < 4; direction++)
+    {
+        for (auto square_index = 0; square_index < 64; square_index++)
+        {
+            int row = square_index / 8 + directions[direction][0];
+            int col = square_index % 8 + directions[direction][1];
+
+            while (row >= 0 && row < 8 && col >= 0 && col < 8)
+            {
+                rays[direction][square_index] |= static_cast<Bitboard>(1)
+                                                 << (row * 8 + col);
+                row += directions[direction][0];
+                col += directions[direction][1];
+            }
+        }
+    }
+
+    return rays;
+}
+
+// The rays of a bishop and a rook from each square.
+constexpr std::array<std::array<Bitboard, 64>, 4> bishop_rays = gen_rays(
+        bishop_directions
+);
+constexpr std::array<std::array<Bitboard, 64>, 4> rook_rays = gen_rays(
+        rook_directions
+);
+
+// Returns the squares attacked by a slider on a square with the specified
+// rays when the board has the specified occupancy. Each ray is cut off behind
+// the first occupied square on it, which is the least significant one on the
+// rays going towards higher squares and the most significant one otherwise.
+// This is only used to generate the attack tables.
+constexpr Bitboard slider_attacks(
+        const std::array<Bitboard, 4> &square_rays,
+        const Bitboard occupancy
+)
+{
+    const Bitboard blockers0 = square_rays[0] & occupancy;
+    const Bitboard blockers1 = square_rays[1] & occupancy;
+    const Bitboard blockers2 = square_rays[2] & occupancy;
+    const Bitboard blockers3 = square_rays[3] & occupancy;
+
+    // Keep the squares up to and including the first blocker. A ray without
+    // blockers is kept whole: x ^ (x - 1) is all ones for x = 0, and the 1
+    // added to the blockers makes -bit_floor() all ones.
+    return (square_rays[0] & (blockers0 ^ (blockers0 - 1))) |
+           (square_rays[1] & (blockers1 ^ (blockers1 - 1))) |
+           (square_rays[2] & -std::bit_floor(blockers2 | 1)) |
+           (square_rays[3] & -std::bit_floor(blockers3 | 1));
+}
+
+// Generates the occupancy bits that change the attacks of a slider on each
+// square. The last square of each ray is left out because a piece on it
+// never blocks another square.
+constexpr std::array<Bitboard, 64> gen_slider_masks(
+        const std::array<std::array<Bitboard, 64>, 4> &rays
+)
+{
+    std::array<Bitboard, 64> masks = {};
+
+    for (auto square_index = 0; square_index < 64; square_index++)
+    {
+        for (auto direction = 0; direction < 4; direction++)
+        {
+            const Bitboard ray = rays[direction][square_index];
+
+            if (ray != 0)
+            {
+                const Bitboard last_square = direction < 2 ?
+                                             std::bit_floor(ray) :
+                                             ray & -ray;
+                masks[square_index] |= ray ^ last_square;
+            }
+        }
+    }
+
+    return masks;
+}
+
+// Generates where the attacks for each square start in a slider attack
+// table. Every square has one entry for each subset of its mask.
+constexpr std::array<unsigned, 64> gen_slider_offsets(
+        const std::array<Bitboard, 64> &masks
+)
+{
+    std::array<unsigned, 64> offsets = {};
+    unsigned offset = 0;
+
+    for (auto square_index = 0; square_index < 64; square_index++)
+    {
+        offsets[square_index] = offset;
+        offset += 1u << std::popcount(masks[square_index]);
+    }
+
+    return offsets;
+}
+
+// Generates where the distinct attack sets of each square start from the
+// number of distinct attack sets of each square.
+constexpr std::array<unsigned, 64> gen_distinct_offsets(
+        const std::array<unsigned, 64> &counts
+)
+{
+    std::array<unsigned, 64> offsets = {};
+    unsigned offset = 0;
+
+    for (auto square_index = 0; square_index < 64; square_index++)
+    {
+        offsets[square_index] = offset;
+        offset += counts[square_index];
+    }
+
+    return offsets;
+}
+
+// Generates the amount the product of the masked occupancy and the magic
+// number of each square is shifted right by to get its index.
+constexpr std::array<unsigned, 64> gen_magic_shifts(
+        const std::array<Bitboard, 64> &masks
+)
+{
+    std::array<unsigned, 64> shifts = {};
+
+    for (auto square_index = 0; square_index < 64; square_index++)
+    {
+        shifts[square_index] = 64 - std::popcount(masks[square_index]);
+    }
+
+    return shifts;
+}
+
+// The occupancy bits that change the attacks of a slider on each square.
+constexpr std::array<Bitboard, 64> bishop_masks = gen_slider_masks(
+        bishop_rays
+);
+constexpr std::array<Bitboard, 64> rook_masks = gen_slider_masks(rook_rays);
+
+// Where the attacks for each square start in the attack tables. The magic
+// and PEXT tables have the same layout.
+constexpr std::array<unsigned, 64> bishop_offsets = gen_slider_offsets(
+        bishop_masks
+);
+constexpr std::array<unsigned, 64> rook_offsets = gen_slider_offsets(
+        rook_masks
+);
+
+// The number of entries in the bishop and rook attack tables.
+constexpr unsigned bishop_table_size = bishop_offsets[63] +
+                                       (1u << std::popcount(bishop_masks[63]));
+constexpr unsigned rook_table_size = rook_offsets[63] +
+                                     (1u << std::popcount(rook_masks[63]));
+
+// Magic numbers that map every relevant occupancy of a square to a different
+// index, or to the same index as an occupancy with the same attacks. They are
+// the numbers from Pradyumna Kannan's magicmoves.
+constexpr std::array<Bitboard, 64> bishop_magics =
+{
+    0x0002020202020200, 0x0002020202020000, 0x0004010202000000,
+    0x0004040080000000, 0x0001104000000000, 0x0000821040000000,
+    0x0000410410400000, 0x0000104104104000, 0x0000040404040400,
+    0x0000020202020200, 0x0000040102020000, 0x0000040400800000,
+    0x0000011040000000, 0x0000008210400000, 0x0000004104104000,
+    0x0000002082082000, 0x0004000808080800, 0x0002000404040400,
+    0x0001000202020200, 0x0000800802004000, 0x0000800400A00000,
+    0x0000200100884000, 0x0000400082082000, 0x0000200041041000,
+    0x0002080010101000, 0x0001040008080800, 0x0000208004010400,
+    0x0000404004010200, 0x0000840000802000, 0x0000404002011000,
+    0x0000808001041000, 0x0000404000820800, 0x0001041000202000,
+    0x0000820800101000, 0x0000104400080800, 0x0000020080080080,
+    0x0000404040040100, 0x0000808100020100, 0x0001010100020800,
+    0x0000808080010400, 0x0000820820004000, 0x0000410410002000,
+    0x0000082088001000, 0x0000002011000800, 0x0000080100400400,
+    0x0001010101000200, 0x0002020202000400, 0x0001010101000200,
+    0x0000410410400000, 0x0000208208200000, 0x0000002084100000,
+    0x0000000020880000, 0x0000001002020000, 0x0000040408020000,
+    0x0004040404040000, 0x0002020202020000, 0x0000104104104000,
+    0x0000002082082000, 0x0000000020841000, 0x0000000000208800,
+    0x0000000010020200, 0x0000000404080200, 0x0000040404040400,
+    0x0002020202020200
+};
+constexpr std::array<Bitboard, 64> rook_magics =
+{
+    0x0080001020400080, 0x0040001000200040, 0x0080081000200080,
+    0x0080040800100080, 0x0080020400080080, 0x0080010200040080,
+    0x0080008001000200, 0x0080002040800100, 0x0000800020400080,
+    0x0000400020005000, 0x0000801000200080, 0x0000800800100080,
+    0x0000800400080080, 0x0000800200040080, 0x0000800100020080,
+    0x0000800040800100, 0x0000208000400080, 0x0000404000201000,
+    0x0000808010002000, 0x0000808008001000, 0x0000808004000800,
+    0x0000808002000400, 0x0000010100020004, 0x0000020000408104,
+    0x0000208080004000, 0x0000200040005000, 0x0000100080200080,
+    0x0000080080100080, 0x0000040080080080, 0x0000020080040080,
+    0x0000010080800200, 0x0000800080004100, 0x0000204000800080,
+    0x0000200040401000, 0x0000100080802000, 0x0000080080801000,
+    0x0000040080800800, 0x0000020080800400, 0x0000020001010004,
+    0x0000800040800100, 0x0000204000808000, 0x0000200040008080,
+    0x0000100020008080, 0x0000080010008080, 0x0000040008008080,
+    0x0000020004008080, 0x0000010002008080, 0x0000004081020004,
+    0x0000204000800080, 0x0000200040008080, 0x0000100020008080,
+    0x0000080010008080, 0x0000040008008080, 0x0000020004008080,
+    0x0000800100020080, 0x0000800041000080, 0x00FFFCDDFCED714A,
+    0x007FFCDDFCED714A, 0x003FFFCDFFD88096, 0x0000040810002101,
+    0x0001000204080011, 0x0001000204000801, 0x0001000082000401,
+    0x0001FFFAABFAD1A2
+};
+
+// The shifts that turn the magic products into indices.
+constexpr std::array<unsigned, 64> bishop_shifts = gen_magic_shifts(
+        bishop_masks
+);
+constexpr std::array<unsigned, 64> rook_shifts = gen_magic_shifts(
+        rook_masks
+);
+
+// Counts the distinct attack sets a slider has on each square. Each ray
+// can end on any of its squares, independently of the other rays.
+constexpr std::array<unsigned, 64> gen_distinct_counts(
+        const std::array<std::array<Bitboard, 64>, 4> &rays
+)
+{
+    std::array<unsigned, 64> counts = {};
+
+    for (auto square_index = 0; square_index < 64; square_index++)
+    {
+        counts[square_index] = 1;
+
+        for (const auto &direction_rays : rays)
+        {
+            if (direction_rays[square_index] != 0)
+            {
+                counts[square_index] *= std::popcount(
+                        direction_rays[square_index]
+                );
+            }
+        }
+    }
+
+    return counts;
+}
+
+// The number of distinct attack sets of a bishop and a rook on each square.
+constexpr std::array<unsigned, 64> bishop_distinct_counts =
+        gen_distinct_counts(bishop_rays);
+constexpr std::array<unsigned, 64> rook_distinct_counts =
+        gen_distinct_counts(rook_rays);
+
+// Where the distinct attack sets of each square start in the distinct attack
+// arrays.
+constexpr std::array<unsigned, 64> bishop_distinct_offsets =
+        gen_distinct_offsets(bishop_distinct_counts);
+constexpr std::array<unsigned, 64> rook_distinct_offsets =
+        gen_distinct_offsets(rook_distinct_counts);
+
+// The number of distinct attack sets of a bishop and a rook on all squares.
+constexpr unsigned bishop_distinct_size = bishop_distinct_offsets[63] +
+                                          bishop_distinct_counts[63];
+constexpr unsigned rook_distinct_size = rook_distinct_offsets[63] +
+                                        rook_distinct_counts[63];
+
+// If COMPACT_SLIDER_ATTACKS is defined when compiling, the attack tables
+// store a 16-bit index into an array of the distinct attack sets instead of
+// the attacks themselves. The tables are then a quarter of the size and fit
+// in the caches more easily, at the cost of a second dependent load.
+#ifdef COMPACT_SLIDER_ATTACKS
+using Slider_entry = std::uint16_t;
+
+static_assert(rook_distinct_size <= 65536,
+              "The distinct rook attacks do not fit in 16-bit indices.");
+
+// The distinct attack sets of a bishop and a rook on each square.
+extern const std::array<Bitboard, bishop_distinct_size>
+        bishop_distinct_attacks;
+extern const std::array<Bitboard, rook_distinct_size> rook_distinct_attacks;
+
+// Returns the attacks of a bishop table entry.
+inline Bitboard bishop_entry_attacks(const Slider_entry entry)
+{
+    return bishop_distinct_attacks[entry];
+}
+
+// Returns the attacks of a rook table entry.
+inline Bitboard rook_entry_attacks(const Slider_entry entry)
+{
+    return rook_distinct_attacks[entry];
+}
+#else
+using Slider_entry = Bitboard;
+
+// Returns the attacks of a bishop table entry.
+inline Bitboard bishop_entry_attacks(const Slider_entry entry)
+{
+    return entry;
+}
+
+// Returns the attacks of a rook table entry.
+inline Bitboard rook_entry_attacks(const Slider_entry entry)
+{
+    return entry;
+}
+#endif
+
+// The attacks for every relevant occupancy of every square, indexed by the
+// offset of the square plus the magic index of the occupancy. They are
+// generated at compile time, so they are read-only data shared by every
+// process.
+extern const std::array<Slider_entry, bishop_table_size> magic_bishop_table;
+extern const std::array<Slider_entry, rook_table_size> magic_rook_table;
+
+// The same attacks indexed by the offset of the square plus the occupancy
+// bits extracted with PEXT.
+extern const std::array<Slider_entry, bishop_table_size> pext_bishop_table;
+extern const std::array<Slider_entry, rook_table_size> pext_rook_table;
+
+// The ways the attacks of sliding pieces can be looked up.
+enum class Slider_backend
+{
+    // Magic bitboards. Works on every CPU.
+    magic,
+
+    // Tables indexed with the PEXT instruction. Needs a CPU with BMI2.
+    pext
+};
+
+// The backend used by bishop_attacks() and rook_attacks(). The fastest
+// backend the CPU supports is chosen when the program starts.
+extern Slider_backend slider_backend;
+
+// Makes bishop_attacks() and rook_attacks() use the specified backend.
+// Returns false and keeps the current backend if the CPU does not support
+// it.
+bool set_slider_backend(const Slider_backend backend);
+
+// Returns the bits of a bitboard selected by a mask, packed into the least
+// significant bits. This is done with the BMI2 PEXT instruction, so it must
+// only be used with the PEXT backend. The instruction is written in inline
+// assembly so that the rest of the engine does not need to be compiled for
+// BMI2 and the lookups can still be inlined.
+inline Bitboard pext(const Bitboard bitboard, const Bitboard mask)
+{
+#ifdef PEXT_SUPPORTED
+    Bitboard result;
+    asm("pextq %2, %1, %0" : "=r" (result) : "r" (bitboard), "rm" (mask));
+    return result;
+#else
+    // The PEXT backend is never chosen without PEXT support.
+    return bitboard & mask;
+#endif
+}
+
+// Returns the squares attacked by a bishop on the specified square using the
+// magic tables.
+inline Bitboard magic_bishop_attacks(
+        const Square square,
+        const Bitboard occupancy
+)
+{
+    const auto index = static_cast<unsigned>(square);
+
+    return bishop_entry_attacks(magic_bishop_table[
+            bishop_offsets[index] +
+            (((occupancy & bishop_masks[index]) * bishop_magics[index]) >>
+             bishop_shifts[index])
+    ]);
+}
+
+// Returns the squares attacked by a rook on the specified square using the
+// magic tables.
+inline Bitboard magic_rook_attacks(
+        const Square square,
+        const Bitboard occupancy
+)
+{
+    const auto index = static_cast<unsigned>(square);
+
+    return rook_entry_attacks(magic_rook_table[
+            rook_offsets[index] +
+            (((occupancy & rook_masks[index]) * rook_magics[index]) >>
+             rook_shifts[index])
+    ]);
+}
+
+// Returns the squares attacked by a bishop on the specified square using the
+// PEXT tables. Must only be used with the PEXT backend.
+inline Bitboard pext_bishop_attacks(
+        const Square square,
+        const Bitboard occupancy
+)
+{
+    const auto index = static_cast<unsigned>(square);
+
+    return bishop_entry_attacks(pext_bishop_table[
+            bishop_offsets[index] + pext(occupancy, bishop_masks[index])
+    ]);
+}
+
+// Returns the squares attacked by a rook on the specified square using the
+// PEXT tables. Must only be used with the PEXT backend.
+inline Bitboard pext_rook_attacks(const Square square, const Bitboard occupancy)
+{
+    const auto index = static_cast<unsigned>(square);
+
+    return rook_entry_attacks(pext_rook_table[
+            rook_offsets[index] + pext(occupancy, rook_masks[index])
+    ]);
+}
+
+// Returns the squares attacked by a bishop on the specified square when the
+// board has the specified occupancy.
+inline Bitboard bishop_attacks(const Square square, const Bitboard occupancy)
+{
+    if (slider_backend == Slider_backend::pext)
+    {
+        return pext_bishop_attacks(square, occupancy);
+    }
+
+    return magic_bishop_attacks(square, occupancy);
+}
+
+// Returns the squares attacked by a rook on the specified square when the
+// board has the specified occupancy.
+inline Bitboard rook_attacks(const Square square, const Bitboard occupancy)
+{
+    if (slider_backend == Slider_backend::pext)
+    {
+        return pext_rook_attacks(square, occupancy);
+    }
+
+    return magic_rook_attacks(square, occupancy);
+}
+
+// Returns the squares strictly between two squares that share a row, column
+// or diagonal. Returns an empty bitboard if they do not share one.
+Bitboard squares_between(const Square square1, const Square square2);
+
+// Returns all the squares of the row, column or diagonal that goes through
+// both squares, including the two squares themselves. Returns an empty
+// bitboard if they do not share one.
+Bitboard line_through(const Square square1, const Square square2);
+
+#endif  //DISCORD_CHESS_BOT_ATTACKS_H
@@ -0,0 +1,363 @@
+#include <vector>
+#include "types.h"
+#include "utils.h"
+#include "batch_attacks.h"
+
+#ifdef AVX2_SUPPORTED
+#include <immintrin.h>
+#endif
+
+
+// Four bitboards in the 64-bit lanes of a 256-bit vector. The vector
+// operators work lane by lane like they do on a single bitboard, so the same
+// templates compute one position with Bitboard and four with Bitboard_x4.
+typedef Bitboard Bitboard_x4 __attribute__((vector_size(32)));
+
+// GCC warns that returning a Bitboard_x4 from a function not compiled for
+// AVX has a different ABI. The templates are flattened into the AVX2
+// function, so a Bitboard_x4 is never passed between functions.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+// Masks that discard the squares that wrapped around to the other side of
+// the board after a shift east or west.
+const Bitboard not_col_a = ~col_a;
+const Bitboard not_col_h = ~col_h;
+const Bitboard not_cols_ab = ~(col_a | col_b);
+const Bitboard not_cols_gh = ~(col_g | col_h);
+
+// Shifts of a bitboard that move every square one step in a direction.
+const int north = 8;
+const int south = -8;
+const int east = 1;
+const int west = -1;
+const int north_east = 9;
+const int north_west = 7;
+const int south_east = -7;
+const int south_west = -9;
+
+
+// Shifts all the squares on the bitboards by the specified number of
+// squares. A positive shift moves them towards H8 and a negative one towards
+// A1.
+template <int shift, typename Bitboards>
+inline Bitboards shift_by(const Bitboards &bitboards)
+{
+    if constexpr (shift > 0)
+    {
+        return bitboards << shift;
+    }
+    else
+    {
+        return bitboards >> -shift;
+    }
+}
+
+
+// Shifts all the squares on the bitboards by the specified number of
+// squares and discards the squares outside the mask.
+template <int shift, Bitboard mask, typename Bitboards>
+inline Bitboards shift_masked(const Bitboards &bitboards)
+{
+    return shift_by<shift>(bitboards) & mask;
+}
+
+
+// Returns the squares attacked by the sliding pieces on the bitboards in one
+// direction when the board has the specified occupancy. The sliders are
+// spread over the empty squares with Kogge-Stone shifts of 1, 2 and 4 steps,
+// so a ray of any length takes 3 steps. The mask discards the squares that
+// wrap around the board.
+template <int shift, Bitboard mask, typename Bitboards>
+inline Bitboards slide(const Bitboards &pieces, const Bitboards &occupancy)
+{
+    Bitboards sliders = pieces;
+    Bitboards empty = ~occupancy & mask;
+
+    sliders |= empty & shift_by<shift>(sliders);
+    empty &= shift_by<shift>(empty);
+    sliders |= empty & shift_by<shift * 2>(sliders);
+    empty &= shift_by<shift * 2>(empty);
+    sliders |= empty & shift_by<shift * 4>(sliders);
+
+    // The sliders attack the square after the last empty one, which is
+    // either occupied or off the board.
+    return shift_masked<shift, mask>(sliders);
+}
+
+
+// Returns the squares attacked by the pieces of a player when the board has
+// the specified occupancy. The pieces are indexed by piece type in the order
+// pawn, knight, bishop, rook, queen, king.
+template <Color color, typename Bitboards>
+inline Bitboards player_attacks(
+        const std::array<Bitboards, 6> &pieces,
+        const Bitboards &occupancy
+)
+{
+    const Bitboards pawns = pieces[0];
+    const Bitboards knights = pieces[1];
+    const Bitboards bishops_queens = pieces[2] | pieces[4];
+    const Bitboards rooks_queens = pieces[3] | pieces[4];
+    const Bitboards king = pieces[5];
+
+    Bitboards attacked;
+
+    if (color == Color::white)
+    {
+        attacked = shift_masked<north_east, not_col_a>(pawns) |
+                   shift_masked<north_west, not_col_h>(pawns);
+    }
+    else
+    {
+        attacked = shift_masked<south_east, not_col_a>(pawns) |
+                   shift_masked<south_west, not_col_h>(pawns);
+    }
+
+    attacked |= shift_masked<17, not_col_a>(knights) |
+                shift_masked<15, not_col_h>(knights) |
+                shift_masked<10, not_cols_ab>(knights) |
+                shift_masked<6, not_cols_gh>(knights) |
+                shift_masked<-6, not_cols_ab>(knights) |
+                shift_masked<-10, not_cols_gh>(knights) |
+                shift_masked<-15, not_col_a>(knights) |
+                shift_masked<-17, not_col_h>(knights);
+
+    attacked |= shift_masked<north, ~0ULL>(king) |
+                shift_masked<south, ~0ULL>(king) |
+                shift_masked<east, not_col_a>(king) |
+                shift_masked<west, not_col_h>(king) |
+                shift_masked<north_east, not_col_a>(king) |
+                shift_masked<north_west, not_col_h>(king) |
+                shift_masked<south_east, not_col_a>(king) |
+                shift_masked<south_west, not_col_h>(king);
+
+    attacked |= slide<north_east, not_col_a>(bishops_queens, occupancy) |
+                slide<north_west, not_col_h>(bishops_queens, occupancy) |
+                slide<south_east, not_col_a>(bishops_queens, occupancy) |
+                slide<south_west, not_col_h>(bishops_queens, occupancy);
+
+    attacked |= slide<north, ~0ULL>(rooks_queens, occupancy) |
+                slide<south, ~0ULL>(rooks_queens, occupancy) |
+                slide<east, not_col_a>(rooks_queens, occupancy) |
+                slide<west, not_col_h>(rooks_queens, occupancy);
+
+    return attacked;
+}
+
+
+// Computes the attacked squares and mobility of both players of a position
+// or a group of positions.
+template <typename Bitboards>
+inline void compute_attacks(
+        const std::array<Bitboards, 6> &white_pieces,
+        const std::array<Bitboards, 6> &black_pieces,
+        std::array<Bitboards, 2> &attacked,
+        std::array<Bitboards, 2> &mobility
+)
+{
+    Bitboards white = white_pieces[0];
+    Bitboards black = black_pieces[0];
+
+    for (unsigned piece_type = 1; piece_type < 6; piece_type++)
+    {
+        white |= white_pieces[piece_type];
+        black |= black_pieces[piece_type];
+    }
+
+    const Bitboards occupancy = white | black;
+
+    attacked[0] = player_attacks<Color::white>(white_pieces, occupancy);
+    attacked[1] = player_attacks<Color::black>(black_pieces, occupancy);
+    mobility[0] = attacked[0] & ~white;
+    mobility[1] = attacked[1] & ~black;
+}
+
+
+// Computes the attacks of the positions in the range one position at a
+// time.
+void scalar_attacks(
+        const std::vector<Board_bitboards> &boards,
+        std::vector<Board_attacks> &attacks,
+        const std::size_t first,
+        const std::size_t last
+)
+{
+    for (auto i = first; i < last; i++)
+    {
+        compute_attacks(
+                boards[i].pieces[0],
+                boards[i].pieces[1],
+                attacks[i].attacked,
+                attacks[i].mobility
+        );
+    }
+}
+
+
+#ifdef AVX2_SUPPORTED
+// The bitboards of a position are loaded and stored as whole vectors.
+static_assert(sizeof(Board_bitboards) == 12 * sizeof(Bitboard),
+              "The bitboards of a position should be 3 vectors long.");
+static_assert(sizeof(Board_attacks) == 4 * sizeof(Bitboard),
+              "The attacks of a position should be 1 vector long.");
+
+
+// Transposes the 4 by 4 matrix of bitboards in the lanes of 4 vectors, so
+// that lane j of vector i ends up in lane i of vector j. This turns 4
+// vectors loaded from 4 positions into 4 vectors that each hold one bitboard
+// of every position, and back.
+__attribute__((target("avx2")))
+inline void transpose(std::array<Bitboard_x4, 4> &rows)
+{
+    const auto row_0 = reinterpret_cast<__m256i>(rows[0]);
+    const auto row_1 = reinterpret_cast<__m256i>(rows[1]);
+    const auto row_2 = reinterpret_cast<__m256i>(rows[2]);
+    const auto row_3 = reinterpret_cast<__m256i>(rows[3]);
+
+    const __m256i low_01 = _mm256_unpacklo_epi64(row_0, row_1);
+    const __m256i high_01 = _mm256_unpackhi_epi64(row_0, row_1);
+    const __m256i low_23 = _mm256_unpacklo_epi64(row_2, row_3);
+    const __m256i high_23 = _mm256_unpackhi_epi64(row_2, row_3);
+
+    rows[0] = reinterpret_cast<Bitboard_x4>(
+            _mm256_permute2x128_si256(low_01, low_23, 0x20)
+    );
+    rows[1] = reinterpret_cast<Bitboard_x4>(
+            _mm256_permute2x128_si256(high_01, high_23, 0x20)
+    );
+    rows[2] = reinterpret_cast<Bitboard_x4>(
+            _mm256_permute2x128_si256(low_01, low_23, 0x31)
+    );
+    rows[3] = reinterpret_cast<Bitboard_x4>(
+            _mm256_permute2x128_si256(high_01, high_23, 0x31)
+    );
+}
+
+
+// Computes the attacks of the positions in the range four positions at a
+// time. The number of positions must be a multiple of 4. Flattening inlines
+// the templates so that the vector operations are compiled for AVX2 too.
+__attribute__((target("avx2"), flatten))
+void avx2_attacks(
+        const std::vector<Board_bitboards> &boards,
+        std::vector<Board_attacks> &attacks,
+        const std::size_t first,
+        const std::size_t last
+)
+{
+    for (auto i = first; i < last; i += 4)
+    {
+        // Loading whole vectors and transposing them avoids building each
+        // vector from 4 separate bitboards, which stalls on store
+        // forwarding.
+        std::array<std::array<Bitboard_x4, 6>, 2> pieces;
+
+        for (unsigned group = 0; group < 3; group++)
+        {
+            std::array<Bitboard_x4, 4> rows;
+
+            for (unsigned lane = 0; lane < 4; lane++)
+            {
+                rows[lane] = reinterpret_cast<Bitboard_x4>(_mm256_loadu_si256(
+                        reinterpret_cast<const __m256i *>(
+                                boards[i + lane].pieces[0].data()
+                        ) + group
+                ));
+            }
+
+            transpose(rows);
+
+            for (unsigned row = 0; row < 4; row++)
+            {
+                const unsigned piece = group * 4 + row;
+                pieces[piece / 6][piece % 6] = rows[row];
+            }
+        }
+
+        std::array<Bitboard_x4, 2> attacked;
+        std::array<Bitboard_x4, 2> mobility;
+
+        compute_attacks(pieces[0], pieces[1], attacked, mobility);
+
+        std::array<Bitboard_x4, 4> rows =
+        {
+            attacked[0],
+            attacked[1],
+            mobility[0],
+            mobility[1]
+        };
+
+        transpose(rows);
+
+        for (unsigned lane = 0; lane < 4; lane++)
+        {
+            _mm256_storeu_si256(
+                    reinterpret_cast<__m256i *>(&attacks[i + lane]),
+                    reinterpret_cast<__m256i>(rows[lane])
+            );
+        }
+    }
+}
+#endif
+
+
+// Checks if the CPU supports AVX2.
+bool avx2_supported()
+{
+#ifdef AVX2_SUPPORTED
+    __builtin_cpu_init();
+
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+
+// Nothing needs to be initialized, so the backend can be chosen before
+// main() runs.
+Batch_backend batch_backend = avx2_supported() ? Batch_backend::avx2 :
+                                                 Batch_backend::scalar;
+
+
+// Makes batch_attacks() use the specified backend. Returns false and keeps
+// the current backend if the CPU does not support it.
+bool set_batch_backend(const Batch_backend backend)
+{
+    if (backend == Batch_backend::avx2 && !avx2_supported())
+    {
+        return false;
+    }
+
+    batch_backend = backend;
+    return true;
+}
+
+
+// Computes the attacked squares and mobility of each position. The sliding
+// pieces are filled along all 8 directions with Kogge-Stone shifts instead
+// of being looked up square by square, so every position takes the same
+// instructions and several positions can be computed at once.
+std::vector<Board_attacks> batch_attacks(
+        const std::vector<Board_bitboards> &boards
+)
+{
+    std::vector<Board_attacks> attacks(boards.size());
+    std::size_t scalar_first = 0;
+
+#ifdef AVX2_SUPPORTED
+    if (batch_backend == Batch_backend::avx2)
+    {
+        // The positions left over after the groups of 4 are done one at a
+        // time.
+        scalar_first = boards.size() - boards.size() % 4;
+        avx2_attacks(boards, attacks, 0, scalar_first);
+    }
+#endif
+
+    scalar_attacks(boards, attacks, scalar_first, boards.size());
+
+    return attacks;
+}
@@ -0,0 +1,62 @@
+#ifndef DISCORD_CHESS_BOT_BATCH_ATTACKS_H
+#define DISCORD_CHESS_BOT_BATCH_ATTACKS_H
+
+#include <array>
+#include <vector>
+#include "types.h"
+
+
+// The AVX2 code is compiled for AVX2 with a function attribute, so the rest
+// of the engine does not need to be.
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define AVX2_SUPPORTED
+#endif
+
+
+// The pieces of a position without the rest of the game state.
+struct Board_bitboards
+{
+    // Indexed by color (0 for white, 1 for black), then by piece type in the
+    // order pawn, knight, bishop, rook, queen, king.
+    std::array<std::array<Bitboard, 6>, 2> pieces;
+};
+
+// The squares attacked by each player of a position, indexed by color (0
+// for white, 1 for black).
+struct Board_attacks
+{
+    // The squares attacked by the player's pieces.
+    std::array<Bitboard, 2> attacked;
+
+    // The attacked squares that are not occupied by the player's own pieces.
+    std::array<Bitboard, 2> mobility;
+};
+
+// The ways the attacks of many positions can be computed.
+enum class Batch_backend
+{
+    // One position at a time. Works on every CPU.
+    scalar,
+
+    // Four positions at a time, one in each 64-bit lane of an AVX2
+    // register. Needs a CPU with AVX2.
+    avx2
+};
+
+// The backend used by batch_attacks(). The fastest backend the CPU supports
+// is chosen when the program starts.
+extern Batch_backend batch_backend;
+
+// Makes batch_attacks() use the specified backend. Returns false and keeps
+// the current backend if the CPU does not support it.
+bool set_batch_backend(const Batch_backend backend);
+
+// Computes the attacked squares and mobility of each position. The sliding
+// pieces are filled along all 8 directions with Kogge-Stone shifts instead
+// of being looked up square by square, so every position takes the same
+// instructions and several positions can be computed at once.
+std::vector<Board_attacks> batch_attacks(
+        const std::vector<Board_bitboards> &boards
+);
+
+#endif  //DISCORD_CHESS_BOT_BATCH_ATTACKS_H
@@ -0,0 +1,123 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../game.h"
+#include "../batch_attacks.h"
+#include "bench_utils.h"
+
+
+// Number of games played to collect positions.
+const unsigned game_count = 200;
+
+// Maximum number of plies played in each game.
+const unsigned max_plies = 120;
+
+// Number of passes over the positions.
+const unsigned pass_count = 200;
+
+
+// Returns the number of positions per second of a run over all the
+// positions that took the specified number of seconds.
+unsigned long long positions_per_sec(
+        const std::size_t positions,
+        const double seconds
+)
+{
+    return static_cast<unsigned long long>(positions * pass_count / seconds);
+}
+
+
+// Checks if two sets of attacks are the same.
+bool same_attacks(const Board_attacks &attacks1, const Board_attacks &attacks2)
+{
+    return attacks1.attacked == attacks2.attacked &&
+           attacks1.mobility == attacks2.mobility;
+}
+
+
+// Compares computing the attacks of many positions one game at a time with
+// the attack tables and all at once with each batch backend.
+int main()
+{
+    const std::vector<Game> games = random_positions(game_count, max_plies);
+    std::vector<Board_bitboards> boards;
+
+    for (const auto &game : games)
+    {
+        boards.push_back(game.board_bitboards());
+    }
+
+    std::cout << games.size() << " positions\n";
+
+    // The checksum makes sure that the work is not optimized away.
+    Bitboard checksum = 0;
+    std::vector<Board_attacks> expected(games.size());
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (unsigned pass = 0; pass < pass_count; pass++)
+    {
+        for (std::size_t i = 0; i < games.size(); i++)
+        {
+            expected[i] = games[i].board_attacks();
+            checksum += expected[i].mobility[0] ^ expected[i].mobility[1];
+        }
+    }
+
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << "per game  " << positions_per_sec(
+            games.size(),
+            std::chrono::duration<double>(end - start).count()
+    ) << " positions/sec\n";
+
+    const std::vector<Batch_backend> backends =
+    {
+        Batch_backend::scalar,
+        Batch_backend::avx2
+    };
+
+    bool all_correct = true;
+
+    for (const auto backend : backends)
+    {
+        const std::string name = backend == Batch_backend::scalar ?
+                                 "scalar" : "avx2  ";
+
+        if (!set_batch_backend(backend))
+        {
+            std::cout << name << "    not supported on this CPU\n";
+            continue;
+        }
+
+        std::vector<Board_attacks> attacks;
+
+        start = std::chrono::steady_clock::now();
+
+        for (unsigned pass = 0; pass < pass_count; pass++)
+        {
+            attacks = batch_attacks(boards);
+            checksum += attacks[pass % attacks.size()].mobility[0];
+        }
+
+        end = std::chrono::steady_clock::now();
+
+        bool correct = true;
+
+        for (std::size_t i = 0; i < games.size(); i++)
+        {
+            correct = correct && same_attacks(attacks[i], expected[i]);
+        }
+
+        all_correct = all_correct && correct;
+
+        std::cout << name << "    " << positions_per_sec(
+                games.size(),
+                std::chrono::duration<double>(end - start).count()
+        ) << " positions/sec" << (correct ? "" : "  MISMATCH") << "\n";
+    }
+
+    return all_correct && checksum != 0 ? 0 : 1;
+}
@@ -0,0 +1,95 @@
+#ifndef DISCORD_CHESS_BOT_BENCH_UTILS_H
+#define DISCORD_CHESS_BOT_BENCH_UTILS_H
+
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../game.h"
+
+
+// Plays a sequence of moves separated by spaces.
+inline void play_moves(Game &game, const std::string &moves)
+{
+    std::istringstream stream(moves);
+    std::string move_str;
+
+    while (stream >> move_str)
+    {
+        game.make_move(game.string_to_move(move_str));
+    }
+}
+
+
+// Returns a random legal move of the current position of a game, or
+// Move::none if there is none.
+inline Move random_legal_move(const Game &game, std::mt19937 &generator)
+{
+    const Move_list moves = game.legal_moves();
+
+    if (moves.empty())
+    {
+        return Move::none;
+    }
+
+    return moves[generator() % moves.size()];
+}
+
+
+// Plays random games from the initial position, always with the same seed.
+// After each move, the function is called with the game and the moves
+// played in it so far. Each game ends after the specified number of plies if
+// it has not ended before.
+template <typename Function>
+void play_random_games(
+        const unsigned game_count,
+        const unsigned max_plies,
+        Function on_move
+)
+{
+    std::mt19937 generator(12345);
+
+    for (unsigned i = 0; i < game_count; i++)
+    {
+        Game game;
+        std::vector<Move> moves;
+
+        for (unsigned ply = 0; ply < max_plies; ply++)
+        {
+            const Move move = random_legal_move(game, generator);
+
+            if (move == Move::none)
+            {
+                break;
+            }
+
+            game.make_move(move);
+            moves.push_back(move);
+            on_move(game, moves);
+        }
+    }
+}
+
+
+// Plays random games like play_random_games() and returns every position
+// reached.
+inline std::vector<Game> random_positions(
+        const unsigned game_count,
+        const unsigned max_plies
+)
+{
+    std::vector<Game> games;
+
+    play_random_games(
+            game_count,
+            max_plies,
+            [&games](const Game &game, const std::vector<Move> &)
+            {
+                games.push_back(game);
+            }
+    );
+
+    return games;
+}
+
+#endif  //DISCORD_CHESS_BOT_BENCH_UTILS_H
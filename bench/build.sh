@@ -0,0 +1,10 @@
+#!/bin/bash
+# Builds each benchmark in this directory against the engine sources.
+cd "$(dirname "$0")"
+for bench in *.cpp; do
+    g++ -O2 -std=c++20 -pthread -o "${bench%.cpp}" "$bench" ../*.cpp
+done
+
+# The cache benchmark is also built with the compact slider attack tables.
+g++ -O2 -std=c++20 -pthread -DCOMPACT_SLIDER_ATTACKS -o compact_cache_bench \
+    cache_bench.cpp ../*.cpp
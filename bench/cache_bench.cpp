@@ -0,0 +1,178 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../game.h"
+#include "../attacks.h"
+
+
+// Number of random (square, occupancy) pairs looked up per pass.
+const unsigned lookup_count = 1 << 16;
+
+// Number of passes over the pairs.
+const unsigned pass_count = 100;
+
+
+// Cheap random numbers for the transposition table indices, so that
+// generating them does not hide the cost of the memory accesses.
+class Xorshift
+{
+private:
+    unsigned long long state = 88172645463325252ULL;
+public:
+    unsigned long long next()
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+};
+
+
+// Looks up the bishop and rook attacks of every pair. If the table is not
+// empty, an entry at a random index of it is also read and written before
+// each lookup, like a search probing and storing in a transposition table.
+// Returns the number of nanoseconds per lookup and sets the checksum to a
+// value that depends on every result.
+double time_lookups(
+        const std::vector<Square> &squares,
+        const std::vector<Bitboard> &occupancies,
+        std::vector<Bitboard> &table,
+        const bool do_lookups,
+        Bitboard &checksum
+)
+{
+    Xorshift random;
+    const Bitboard index_mask = table.size() - 1;
+    checksum = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (unsigned pass = 0; pass < pass_count; pass++)
+    {
+        for (unsigned i = 0; i < lookup_count; i++)
+        {
+            // The table entry does not depend on the lookups, so the
+            // accesses can overlap with them like they would in a search.
+            if (!table.empty())
+            {
+                Bitboard &entry = table[random.next() & index_mask];
+                checksum -= entry;
+                entry = i;
+            }
+
+            if (do_lookups)
+            {
+                checksum += bishop_attacks(squares[i], occupancies[i]);
+                checksum ^= rook_attacks(squares[i], occupancies[i]);
+            }
+        }
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count() /
+           (static_cast<double>(lookup_count) * pass_count);
+}
+
+
+// Runs perft with a perft hash table of the specified size and returns the
+// number of nodes per second.
+unsigned long long time_perft(const unsigned hash_mb)
+{
+    Game game;
+
+    const auto start = std::chrono::steady_clock::now();
+    const unsigned long long nodes = game.perft(6, 1, hash_mb);
+    const auto end = std::chrono::steady_clock::now();
+
+    return static_cast<unsigned long long>(
+            nodes / std::chrono::duration<double>(end - start).count()
+    );
+}
+
+
+// Usage: cache_bench [table_mb]
+// Measures slider attack lookups with and without a transposition table of
+// the specified size (256 MB by default) competing for the caches. Build
+// with -DCOMPACT_SLIDER_ATTACKS to measure the compact table layout.
+int main(int argc, char *argv[])
+{
+    const unsigned table_mb = argc > 1 ? std::atoi(argv[1]) : 256;
+
+#ifdef COMPACT_SLIDER_ATTACKS
+    std::cout << "layout: compact";
+#else
+    std::cout << "layout: full";
+#endif
+    std::cout << ", backend: "
+              << (slider_backend == Slider_backend::pext ? "pext" : "magic")
+              << ", tables: "
+              << (sizeof(magic_rook_table) + sizeof(magic_bishop_table)) / 1024
+#ifdef COMPACT_SLIDER_ATTACKS
+              << " KB + distinct attacks "
+              << (sizeof(rook_distinct_attacks) +
+                  sizeof(bishop_distinct_attacks)) / 1024
+#endif
+              << " KB\n";
+
+    // Random occupancies with about a quarter of the squares occupied, like
+    // a middlegame position.
+    std::mt19937_64 generator(12345);
+    std::vector<Square> squares(lookup_count);
+    std::vector<Bitboard> occupancies(lookup_count);
+
+    for (unsigned i = 0; i < lookup_count; i++)
+    {
+        squares[i] = static_cast<Square>(generator() % 64);
+        occupancies[i] = generator() & generator();
+    }
+
+    // The number of entries is a power of two so that the index can be
+    // computed with a mask.
+    unsigned long long table_size = 1;
+
+    while (table_size * 2 * sizeof(Bitboard) <=
+           static_cast<unsigned long long>(table_mb) << 20)
+    {
+        table_size *= 2;
+    }
+
+    std::vector<Bitboard> no_table;
+    std::vector<Bitboard> table(table_size, 1);
+    Bitboard checksum;
+
+    const double lookups = time_lookups(
+            squares,
+            occupancies,
+            no_table,
+            true,
+            checksum
+    );
+    const double table_accesses = time_lookups(
+            squares,
+            occupancies,
+            table,
+            false,
+            checksum
+    );
+    const double both = time_lookups(
+            squares,
+            occupancies,
+            table,
+            true,
+            checksum
+    );
+
+    std::cout << "lookups alone          " << lookups << " ns\n"
+              << "table accesses alone   " << table_accesses << " ns\n"
+              << "lookups + accesses     " << both << " ns  (lookups add "
+              << both - table_accesses << " ns)\n"
+              << "perft 6 with " << table_mb << " MB hash  "
+              << time_perft(table_mb) << " nodes/sec\n";
+
+    // Use the checksum so that the work is not optimized away.
+    return checksum == 0 ? 1 : 0;
+}
@@ -0,0 +1,77 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../game.h"
+#include "../position.h"
+#include "bench_utils.h"
+
+
+// Move sequences from the initial position to the positions searched.
+const std::vector<std::string> positions =
+{
+    // Initial position
+    "",
+    // Ruy Lopez, both sides can castle
+    "e2e4 e7e5 g1f3 b8c6 f1b5 a7a6 b5a4 g8f6",
+    // Queen's gambit declined
+    "d2d4 d7d5 c2c4 e7e6 b1c3 g8f6 c1g5 f8e7"
+};
+
+// Depth of the perft run on each position.
+const int depth = 5;
+
+
+// Runs perft on every position, taking back the moves as the mode specifies.
+// Returns the number of nodes per second and sets the total number of nodes.
+unsigned long long time_perft(
+        const Make_mode mode,
+        unsigned long long &total_nodes
+)
+{
+    total_nodes = 0;
+    double total_seconds = 0;
+
+    for (const auto &moves : positions)
+    {
+        Game game;
+        play_moves(game, moves);
+
+        const auto start = std::chrono::steady_clock::now();
+        total_nodes += game.perft(depth, 1, 0, mode);
+        const auto end = std::chrono::steady_clock::now();
+
+        total_seconds += std::chrono::duration<double>(end - start).count();
+    }
+
+    return static_cast<unsigned long long>(total_nodes / total_seconds);
+}
+
+
+// Compares taking back moves by undoing them with the saved ply data and by
+// restoring a copy of the position made before each move.
+int main()
+{
+    std::cout << "sizeof(Position) " << sizeof(Position)
+              << "  sizeof(Ply_data) " << sizeof(Ply_data)
+              << "  sizeof(Game) " << sizeof(Game) << "\n";
+
+    unsigned long long make_undo_nodes;
+    unsigned long long copy_make_nodes;
+
+    const unsigned long long make_undo = time_perft(
+            Make_mode::make_undo,
+            make_undo_nodes
+    );
+    const unsigned long long copy_make = time_perft(
+            Make_mode::copy_make,
+            copy_make_nodes
+    );
+
+    std::cout << "make/undo  " << make_undo << " nodes/sec\n"
+              << "copy-make  " << copy_make << " nodes/sec"
+              << (copy_make_nodes == make_undo_nodes ? "" : "  MISMATCH")
+              << "\n";
+
+    return copy_make_nodes == make_undo_nodes ? 0 : 1;
+}
@@ -0,0 +1,169 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../game.h"
+#include "bench_utils.h"
+
+
+// Number of games played to collect positions.
+const unsigned game_count = 100;
+
+// Maximum number of plies played in each game.
+const unsigned max_plies = 120;
+
+// Number of passes over the positions.
+const unsigned pass_count = 20;
+
+
+// FENs that must be rejected, each with a different error.
+const std::vector<std::string> invalid_fens =
+{
+    // Empty castling field
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w  - 0 1",
+    // Consecutive digits in a row
+    "rnbqkbnr/pppppppp/44/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    // Fullmove number whose number of plies does not fit
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 4294967295",
+    // More promoted pieces than missing pawns, with more moves than a move
+    // list holds
+    "QQQQQ1rk/Q4Qpp/Q5Q1/Q6Q/Q6Q/Q6Q/1Q5Q/K1QQQQQQ w - - 0 1",
+    // Nine pawns
+    "rnbqkbnr/pppppppp/8/8/8/P7/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    // Three knights with all the pawns still on the board
+    "rnbqkbnr/pppppppp/8/8/8/2N5/PPPPPPPP/RNBQKBNR w KQkq - 0 1"
+};
+
+
+// A position reached in a random game, with the moves that lead to it.
+struct Game_position
+{
+    std::string fen;
+    std::vector<std::string> moves;
+};
+
+
+// Plays random games and returns every position reached.
+std::vector<Game_position> random_fen_positions()
+{
+    std::vector<Game_position> positions;
+
+    play_random_games(
+            game_count,
+            max_plies,
+            [&positions](const Game &game, const std::vector<Move> &moves)
+            {
+                std::vector<std::string> move_strings;
+
+                for (const auto move : moves)
+                {
+                    move_strings.push_back(game.move_to_string(move));
+                }
+
+                positions.push_back({game.fen(), move_strings});
+            }
+    );
+
+    return positions;
+}
+
+
+// Returns the number of positions per second of a run over all the
+// positions that took the specified number of seconds.
+unsigned long long positions_per_sec(
+        const std::size_t positions,
+        const unsigned passes,
+        const double seconds
+)
+{
+    return static_cast<unsigned long long>(positions * passes / seconds);
+}
+
+
+// Compares loading positions by parsing their FEN and by replaying the moves
+// that lead to them, and measures writing the FEN of each position.
+int main()
+{
+    const std::vector<Game_position> positions = random_fen_positions();
+    std::vector<Game> games(positions.size());
+
+    std::cout << positions.size() << " positions\n";
+
+    // The checksum makes sure that the work is not optimized away.
+    unsigned long long checksum = 0;
+    bool all_correct = true;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (unsigned pass = 0; pass < pass_count; pass++)
+    {
+        for (std::size_t i = 0; i < positions.size(); i++)
+        {
+            all_correct = games[i].set_fen(positions[i].fen) && all_correct;
+        }
+    }
+
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << "set_fen   " << positions_per_sec(
+            positions.size(),
+            pass_count,
+            std::chrono::duration<double>(end - start).count()
+    ) << " positions/sec\n";
+
+    start = std::chrono::steady_clock::now();
+
+    for (unsigned pass = 0; pass < pass_count; pass++)
+    {
+        for (const auto &game : games)
+        {
+            checksum += game.fen().size();
+        }
+    }
+
+    end = std::chrono::steady_clock::now();
+
+    std::cout << "fen       " << positions_per_sec(
+            positions.size(),
+            pass_count,
+            std::chrono::duration<double>(end - start).count()
+    ) << " positions/sec\n";
+
+    // An invalid FEN must be rejected.
+    for (const auto &fen : invalid_fens)
+    {
+        Game game;
+        all_correct = !game.set_fen(fen) && all_correct;
+    }
+
+    // A parsed position must write the same FEN it was parsed from.
+    for (std::size_t i = 0; i < positions.size(); i++)
+    {
+        all_correct = all_correct && games[i].fen() == positions[i].fen;
+    }
+
+    // Replaying is much slower, so it only gets one pass.
+    start = std::chrono::steady_clock::now();
+
+    for (const auto &position : positions)
+    {
+        Game game;
+
+        for (const auto &move : position.moves)
+        {
+            game.make_move(game.string_to_move(move));
+        }
+
+        checksum += game.get_turn() == Color::white;
+    }
+
+    end = std::chrono::steady_clock::now();
+
+    std::cout << "replay    " << positions_per_sec(
+            positions.size(),
+            1,
+            std::chrono::duration<double>(end - start).count()
+    ) << " positions/sec" << (all_correct ? "" : "  MISMATCH") << "\n";
+
+    return all_correct && checksum != 0 ? 0 : 1;
+}
@@ -0,0 +1,105 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../game.h"
+#include "bench_utils.h"
+
+
+// Number of games played to collect positions.
+const unsigned game_count = 200;
+
+// Maximum number of plies played in each game.
+const unsigned max_plies = 120;
+
+// Number of passes over the positions.
+const unsigned pass_count = 200;
+
+// A position one ply before a 50-move rule draw, where passing the turn must
+// not reset the halfmove clock.
+const std::string fifty_move_fen = "7k/8/8/8/8/8/8/R6K w - - 99 80";
+
+
+// Checks that making and undoing a null move gives back the same position
+// and key, and that a null move is refused when the player to move is in
+// check.
+bool check_null_move(Game &game)
+{
+    const std::string fen = game.fen();
+    const Bitstring key = game.hash();
+
+    if (!game.make_null_move())
+    {
+        return game.fen() == fen && game.hash() == key;
+    }
+
+    // Passing the turn must change the key.
+    if (game.hash() == key)
+    {
+        return false;
+    }
+
+    game.undo_null_move();
+
+    return game.fen() == fen && game.hash() == key;
+}
+
+
+// Checks that a null move keeps the halfmove clock, so that the 50-move rule
+// still ends the game right after it.
+bool check_fifty_move()
+{
+    Game game;
+
+    if (!game.set_fen(fifty_move_fen) || !game.make_null_move() ||
+        game.fen() != "7k/8/8/8/8/8/8/R6K b - - 99 80" ||
+        !game.make_move(game.string_to_move("h8g8")))
+    {
+        return false;
+    }
+
+    return game.game_state() == Game_state::fifty_move;
+}
+
+
+// Measures making and undoing a null move on many positions and checks that
+// it gives back the same positions.
+int main()
+{
+    std::vector<Game> games = random_positions(game_count, max_plies);
+
+    std::cout << games.size() << " positions\n";
+
+    bool all_correct = check_fifty_move();
+
+    for (auto &game : games)
+    {
+        all_correct = check_null_move(game) && all_correct;
+    }
+
+    // The checksum makes sure that the work is not optimized away.
+    Bitstring checksum = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (unsigned pass = 0; pass < pass_count; pass++)
+    {
+        for (auto &game : games)
+        {
+            if (game.make_null_move())
+            {
+                checksum += game.hash();
+                game.undo_null_move();
+            }
+        }
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(end - start).count();
+
+    std::cout << "make/undo null  " << static_cast<unsigned long long>(
+            games.size() * pass_count / seconds
+    ) << " positions/sec" << (all_correct ? "" : "  MISMATCH") << "\n";
+
+    return all_correct && checksum != 0 ? 0 : 1;
+}
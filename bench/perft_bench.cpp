@@ -0,0 +1,136 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../game.h"
+#include "bench_utils.h"
+#include "../attacks.h"
+
+
+// A reference position reached by playing a move sequence from a position
+// given in FEN, with its known perft result.
+struct Reference_position
+{
+    // Empty for the initial position
+    std::string fen;
+    std::string moves;
+    int depth;
+    unsigned long long nodes;
+};
+
+// The node counts were verified with an independent move generator. The
+// positions given in FEN are the standard perft test positions.
+const std::vector<Reference_position> positions =
+{
+    // Initial position
+    {"", "", 5, 4865609},
+    // Ruy Lopez, both sides can castle
+    {"", "e2e4 e7e5 g1f3 b8c6 f1b5 a7a6 b5a4 g8f6", 4, 698736},
+    // Alekhine's defence, en passant is possible
+    {"", "e2e4 g8f6 e4e5 d7d5", 4, 799610},
+    // A white pawn on the 7th row can promote by capturing
+    {"", "a2a4 b7b5 a4b5 a7a6 b5a6 c8b7 a6b7 b8c6", 4, 775934},
+    // Queen's gambit declined
+    {"", "d2d4 d7d5 c2c4 e7e6 b1c3 g8f6 c1g5 f8e7", 4, 1454807},
+    // Kiwipete, with castling, pins, en passant and promotions
+    {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "",
+        4,
+        4085603
+    },
+    // Rook and pawn endgame with en passant discovered checks
+    {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", "", 5, 674624},
+    // Promotions and castling out of check
+    {
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "",
+        4,
+        422333
+    },
+    // Promotion with capture next to a castling king
+    {
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "",
+        4,
+        2103487
+    }
+};
+
+
+// Usage:
+//   perft_bench [threads] [hash_mb]
+//       Runs perft on the reference positions and reports nodes/sec.
+//   perft_bench divide <depth> [threads] [hash_mb] [moves...]
+//       Prints the node count below each move of the position reached by
+//       playing the moves.
+int main(int argc, char *argv[])
+{
+    if (argc > 2 && std::string(argv[1]) == "divide")
+    {
+        const int depth = std::atoi(argv[2]);
+        const unsigned threads = argc > 3 ? std::atoi(argv[3]) : 1;
+        const unsigned hash_mb = argc > 4 ? std::atoi(argv[4]) : 0;
+
+        std::string moves;
+        for (auto i = 5; i < argc; i++)
+        {
+            moves += std::string(argv[i]) + " ";
+        }
+
+        Game game;
+        play_moves(game, moves);
+        std::cout << game.divide(depth, threads, hash_mb);
+        return 0;
+    }
+
+    const unsigned threads = argc > 1 ? std::atoi(argv[1]) : 1;
+    const unsigned hash_mb = argc > 2 ? std::atoi(argv[2]) : 0;
+
+    unsigned long long total_nodes = 0;
+    double total_seconds = 0;
+    bool all_correct = true;
+
+    for (const auto &position : positions)
+    {
+        Game game;
+
+        if (!position.fen.empty())
+        {
+            game.set_fen(position.fen);
+        }
+
+        play_moves(game, position.moves);
+
+        const auto start = std::chrono::steady_clock::now();
+        const unsigned long long nodes = game.perft(
+                position.depth,
+                threads,
+                hash_mb
+        );
+        const auto end = std::chrono::steady_clock::now();
+
+        const double seconds = std::chrono::duration<double>(
+                end - start
+        ).count();
+
+        const bool correct = nodes == position.nodes;
+        all_correct = all_correct && correct;
+
+        std::cout << "depth " << position.depth << "  nodes " << nodes
+                  << (correct ? "" : "  WRONG, expected " +
+                                     std::to_string(position.nodes))
+                  << "  " << static_cast<unsigned long long>(nodes / seconds)
+                  << " nodes/sec\n";
+
+        total_nodes += nodes;
+        total_seconds += seconds;
+    }
+
+    std::cout << "total nodes " << total_nodes << "  "
+              << static_cast<unsigned long long>(total_nodes / total_seconds)
+              << " nodes/sec\n";
+
+    return all_correct ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../game.h"
+#include "../attacks.h"
+#include "bench_utils.h"
+
+
+// The depth passed to best_move(). This is the depth the bot plays at.
+const int search_depth = 2;
+
+// Move sequences played from the initial position to reach the benchmark
+// positions.
+const std::vector<std::string> positions =
+{
+    "",
+    "e2e4 e7e5 g1f3 b8c6 f1b5 a7a6 b5a4 g8f6 e1g1 f8e7",
+    "d2d4 g8f6 c2c4 e7e6 b1c3 f8b4 e2e3 e8g8 f1d3 d7d5",
+    "e2e4 c7c5 g1f3 d7d6 d2d4 c5d4 f3d4 g8f6 b1c3 a7a6",
+    "e2e4 e7e6 d2d4 d7d5 b1c3 g8f6 c1g5 f8e7 e4e5 f6d7 g5e7 d8e7 f2f4 e8g8"
+};
+
+
+// Searches every position, taking back the moves as the mode specifies, and
+// prints the best move and speed of each search. Returns the best moves and
+// sets the total number of nodes.
+std::vector<std::string> run_searches(
+        const Make_mode mode,
+        unsigned long long &total_nodes
+)
+{
+    std::vector<std::string> best_moves;
+    double total_seconds = 0;
+    total_nodes = 0;
+
+    for (const auto &moves : positions)
+    {
+        Game game;
+        play_moves(game, moves);
+
+        const auto start = std::chrono::steady_clock::now();
+        const Move move = game.best_move(search_depth, mode);
+        const auto end = std::chrono::steady_clock::now();
+
+        const double seconds = std::chrono::duration<double>(
+                end - start
+        ).count();
+
+        best_moves.push_back(game.move_to_string(move));
+        std::cout << best_moves.back() << "  nodes "
+                  << game.get_nodes() << "  "
+                  << static_cast<unsigned long long>(
+                          game.get_nodes() / seconds
+                  ) << " nodes/sec\n";
+
+        total_nodes += game.get_nodes();
+        total_seconds += seconds;
+    }
+
+    std::cout << "total nodes " << total_nodes << "  "
+              << static_cast<unsigned long long>(total_nodes / total_seconds)
+              << " nodes/sec\n";
+
+    return best_moves;
+}
+
+
+// Compares searching with moves taken back by undoing them and by restoring
+// a copy of the position. Both must find the same moves with the same number
+// of nodes.
+int main()
+{
+    unsigned long long make_undo_nodes;
+    unsigned long long copy_make_nodes;
+
+    std::cout << "make/undo\n";
+    const std::vector<std::string> make_undo_moves = run_searches(
+            Make_mode::make_undo,
+            make_undo_nodes
+    );
+
+    std::cout << "copy-make\n";
+    const std::vector<std::string> copy_make_moves = run_searches(
+            Make_mode::copy_make,
+            copy_make_nodes
+    );
+
+    const bool same = make_undo_moves == copy_make_moves &&
+                      make_undo_nodes == copy_make_nodes;
+
+    if (!same)
+    {
+        std::cout << "MISMATCH\n";
+    }
+
+    return same ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "../game.h"
+#include "../attacks.h"
+
+
+// Number of random (square, occupancy) pairs looked up per pass.
+const unsigned lookup_count = 1 << 16;
+
+// Number of passes over the pairs.
+const unsigned pass_count = 200;
+
+
+// Looks up the bishop and rook attacks of every pair with the current
+// backend. Returns the number of nanoseconds per lookup and sets the
+// checksum to a value that depends on every result.
+double time_lookups(
+        const std::vector<Square> &squares,
+        const std::vector<Bitboard> &occupancies,
+        Bitboard &checksum
+)
+{
+    checksum = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (unsigned pass = 0; pass < pass_count; pass++)
+    {
+        for (unsigned i = 0; i < lookup_count; i++)
+        {
+            checksum += bishop_attacks(squares[i], occupancies[i]);
+            checksum ^= rook_attacks(squares[i], occupancies[i]);
+        }
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count() /
+           (2.0 * lookup_count * pass_count);
+}
+
+
+// Runs perft on the initial position with the current backend and returns
+// the number of nodes per second.
+unsigned long long time_perft()
+{
+    Game game;
+
+    const auto start = std::chrono::steady_clock::now();
+    const unsigned long long nodes = game.perft(5);
+    const auto end = std::chrono::steady_clock::now();
+
+    return static_cast<unsigned long long>(
+            nodes / std::chrono::duration<double>(end - start).count()
+    );
+}
+
+
+// Compares magic and PEXT slider attack lookups on this CPU.
+int main()
+{
+    std::cout << "backend chosen at startup: "
+              << (slider_backend == Slider_backend::pext ? "pext" : "magic")
+              << "\n";
+
+    // Random occupancies with about a quarter of the squares occupied, like
+    // a middlegame position.
+    std::mt19937_64 generator(12345);
+    std::vector<Square> squares(lookup_count);
+    std::vector<Bitboard> occupancies(lookup_count);
+
+    for (unsigned i = 0; i < lookup_count; i++)
+    {
+        squares[i] = static_cast<Square>(generator() % 64);
+        occupancies[i] = generator() & generator();
+    }
+
+    const std::vector<Slider_backend> backends =
+    {
+        Slider_backend::magic,
+        Slider_backend::pext
+    };
+
+    Bitboard magic_checksum = 0;
+
+    for (const auto backend : backends)
+    {
+        const std::string name = backend == Slider_backend::magic ? "magic" :
+                                                                    "pext";
+
+        if (!set_slider_backend(backend))
+        {
+            std::cout << name << "  not supported on this CPU\n";
+            continue;
+        }
+
+        Bitboard checksum;
+        const double nanoseconds = time_lookups(
+                squares,
+                occupancies,
+                checksum
+        );
+
+        if (backend == Slider_backend::magic)
+        {
+            magic_checksum = checksum;
+        }
+
+        std::cout << name << "  " << nanoseconds << " ns/lookup  perft "
+                  << time_perft() << " nodes/sec"
+                  << (checksum == magic_checksum ? "" : "  MISMATCH") << "\n";
+    }
+}
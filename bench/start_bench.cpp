@@ -0,0 +1,204 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../game.h"
+#include "../game_pool.h"
+
+
+// Number of games started at once in a burst.
+const unsigned burst_size = 500;
+
+// Number of bursts run with each way of starting games.
+const unsigned burst_count = 20;
+
+// The moves played in every game before it ends.
+const std::string opening =
+        "e2e4 e7e5 g1f3 b8c6 f1b5 a7a6 b5a4 g8f6 e1g1 f8e7 f1e1 b7b5";
+
+// Number of allocations made since the program started.
+unsigned long long allocations = 0;
+
+
+// Counts every allocation made by the program.
+void *operator new(const std::size_t size)
+{
+    allocations++;
+
+    if (void *memory = std::malloc(size == 0 ? 1 : size))
+    {
+        return memory;
+    }
+
+    throw std::bad_alloc();
+}
+
+
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+
+void operator delete(void *memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+
+// The ways a game can be started.
+enum class Start_mode
+{
+    construct,
+    clone,
+    pool
+};
+
+
+// The results of running bursts of game starts.
+struct Burst_result
+{
+    // Average time taken to start a game, in microseconds.
+    double start_us;
+
+    // Average time taken by a whole burst, in milliseconds.
+    double burst_ms;
+
+    // Average number of allocations made by each game, from its start to its
+    // end.
+    double allocations_per_game;
+};
+
+
+// Converts a sequence of moves separated by spaces into moves.
+std::vector<Move> parse_moves(const std::string &moves)
+{
+    Game game;
+    std::istringstream stream(moves);
+    std::string move_str;
+    std::vector<Move> parsed_moves;
+
+    while (stream >> move_str)
+    {
+        parsed_moves.push_back(game.string_to_move(move_str));
+        game.make_move(parsed_moves.back());
+    }
+
+    return parsed_moves;
+}
+
+
+// Starts a burst of games at once, plays the moves in each of them and ends
+// them all, the way a busy bot would. Returns the averages over all the
+// bursts.
+Burst_result run_bursts(const Start_mode mode, const std::vector<Move> &moves)
+{
+    const Game prototype;
+    Game_pool pool;
+    std::vector<std::unique_ptr<Game>> owned_games;
+    std::vector<Game *> games;
+
+    owned_games.reserve(burst_size);
+    games.reserve(burst_size);
+
+    double start_seconds = 0;
+    double burst_seconds = 0;
+    const unsigned long long first_allocation = allocations;
+
+    for (unsigned burst = 0; burst < burst_count; burst++)
+    {
+        const auto burst_start = std::chrono::steady_clock::now();
+
+        for (unsigned i = 0; i < burst_size; i++)
+        {
+            const auto start = std::chrono::steady_clock::now();
+
+            switch (mode)
+            {
+                case Start_mode::construct:
+                    owned_games.push_back(std::make_unique<Game>());
+                    games.push_back(owned_games.back().get());
+                    break;
+                case Start_mode::clone:
+                    owned_games.push_back(
+                            std::make_unique<Game>(prototype.clone())
+                    );
+                    games.push_back(owned_games.back().get());
+                    break;
+                case Start_mode::pool:
+                    games.push_back(pool.acquire());
+                    break;
+            }
+
+            const auto end = std::chrono::steady_clock::now();
+            start_seconds += std::chrono::duration<double>(end - start)
+                             .count();
+        }
+
+        for (const auto game : games)
+        {
+            for (const auto move : moves)
+            {
+                game->make_move(move);
+            }
+        }
+
+        if (mode == Start_mode::pool)
+        {
+            for (const auto game : games)
+            {
+                pool.release(game);
+            }
+        }
+
+        games.clear();
+        owned_games.clear();
+
+        const auto burst_end = std::chrono::steady_clock::now();
+        burst_seconds += std::chrono::duration<double>(
+                burst_end - burst_start
+        ).count();
+    }
+
+    const double game_count = burst_size * burst_count;
+
+    return {
+        start_seconds / game_count * 1e6,
+        burst_seconds / burst_count * 1e3,
+        (allocations - first_allocation) / game_count
+    };
+}
+
+
+// Compares starting games by constructing them, by cloning a game at the
+// initial position and by taking them from a pool, under bursts of hundreds
+// of starts.
+int main()
+{
+    const std::vector<Move> moves = parse_moves(opening);
+
+    std::cout << burst_count << " bursts of " << burst_size << " games, "
+              << moves.size() << " plies each\n";
+
+    const std::vector<std::pair<std::string, Start_mode>> modes =
+    {
+        {"construct", Start_mode::construct},
+        {"clone    ", Start_mode::clone},
+        {"pool     ", Start_mode::pool}
+    };
+
+    for (const auto &[name, mode] : modes)
+    {
+        const Burst_result result = run_bursts(mode, moves);
+
+        std::cout << name << "  start " << result.start_us << " us  burst "
+                  << result.burst_ms << " ms  "
+                  << result.allocations_per_game << " allocations/game\n";
+    }
+
+    return 0;
+}
@@ -1,135 +1,56 @@
-#include <map>
-#include <string>
-#include <cctype>
+#include <algorithm>
 #include "types.h"
 #include "utils.h"
 #include "game.h"
+#include "attacks.h"
 
 
-std::map<Piece, std::string> piece_fen =
-{
-    {Piece::w_pawn,   "P"},
-    {Piece::w_knight, "N"},
-    {Piece::w_bishop, "B"},
-    {Piece::w_rook,   "R"},
-    {Piece::w_queen,  "Q"},
-    {Piece::w_king,   "K"},
-    {Piece::b_pawn,   "p"},
-    {Piece::b_knight, "n"},
-    {Piece::b_bishop, "b"},
-    {Piece::b_rook,   "r"},
-    {Piece::b_queen,  "q"},
-    {Piece::b_king,   "k"}
-};
-
-
-// Returns a reference to the specified piece type's bitboard.
-Bitboard &Game::get_piece_bitboard(const Piece piece)
-{
-    switch (piece)
-    {
-        case Piece::w_pawn:
-            return w_pawn_bitboard;
-        case Piece::w_knight:
-            return w_knight_bitboard;
-        case Piece::w_bishop:
-            return w_bishop_bitboard;
-        case Piece::w_rook:
-            return w_rook_bitboard;
-        case Piece::w_queen:
-            return w_queen_bitboard;
-        case Piece::w_king:
-            return w_king_bitboard;
-
-        case Piece::b_pawn:
-            return b_pawn_bitboard;
-        case Piece::b_knight:
-            return b_knight_bitboard;
-        case Piece::b_bishop:
-            return b_bishop_bitboard;
-        case Piece::b_rook:
-            return b_rook_bitboard;
-        case Piece::b_queen:
-            return b_queen_bitboard;
-        case Piece::b_king:
-            return b_king_bitboard;
-    }
-}
-
-
-// Returns a reference to the specified color's bitboard.
-Bitboard &Game::get_color_bitboard(const Color color)
-{
-    if (color == Color::white)
-    {
-        return white_bitboard;
-    }
-    else
-    {
-        return black_bitboard;
-    }
-}
-
-
-// Adds a piece to the specified square.
+// Adds a piece to the specified square. The piece must not be none.
 void Game::add_piece(const Piece piece, const Square square)
 {
-    if (piece == Piece::none)
-    {
-        return;
-    }
-
     const Bitboard piece_position = square_to_bb(square);
-    auto &piece_bitboard = get_piece_bitboard(piece);
-    auto &color_bitboard = get_color_bitboard(piece_color(piece));
+    const unsigned color = piece_color_index(piece);
 
     // Update bitboards.
-    piece_bitboard |= piece_position;
-    color_bitboard |= piece_position;
-    all_bitboard |= piece_position;
+    position.piece_bitboards[color][piece_type_index(piece)] |= piece_position;
+    position.color_bitboards[color] |= piece_position;
 
     // Update the piece array.
-    pieces_on_board[static_cast<unsigned>(square)] = piece;
+    position.pieces_on_board[static_cast<unsigned>(square)] = piece;
 
     // Update the position hash.
-    position_hash ^= hash_square(square);
+    position.key ^= hash_piece(piece, square);
 
     // Update the evaluation.
-    evaluation += eval_square(square);
+    position.evaluation += eval_piece(piece, square);
 }
 
 
-// Removes a piece from the specified square.
+// Removes a piece from the specified square. The piece must not be none.
 void Game::remove_piece(const Piece piece, const Square square)
 {
-    if (piece == Piece::none)
-    {
-        return;
-    }
-    // Update the evaluation.
-    evaluation -= eval_square(square);
-
-    // Update the position hash.
-    position_hash ^= hash_square(square);
-
     const Bitboard piece_position = square_to_bb(square);
-    Bitboard &piece_bitboard = get_piece_bitboard(piece);
-    Bitboard &color_bitboard = get_color_bitboard(piece_color(piece));
+    const unsigned color = piece_color_index(piece);
 
     // Update bitboards.
-    piece_bitboard &= ~piece_position;
-    color_bitboard &= ~piece_position;
-    all_bitboard &= ~piece_position;
+    position.piece_bitboards[color][piece_type_index(piece)] &= ~piece_position;
+    position.color_bitboards[color] &= ~piece_position;
 
     // Update the piece array.
-    pieces_on_board[static_cast<unsigned>(square)] = Piece::none;
+    position.pieces_on_board[static_cast<unsigned>(square)] = Piece::none;
+
+    // Update the position hash.
+    position.key ^= hash_piece(piece, square);
+
+    // Update the evaluation.
+    position.evaluation -= eval_piece(piece, square);
 }
 
 
 // Gets the type of piece on a certain square.
 Piece Game::piece_on(const Square square) const
 {
-    return pieces_on_board[static_cast<unsigned>(square)];
+    return position.pieces_on_board[static_cast<unsigned>(square)];
 }
 
 
@@ -137,37 +58,40 @@ Piece Game::piece_on(const Square square) const
 // to be possible.
 bool Game::insufficient_material() const
 {
-    // If any pawns, rooks, or queens exist on the board, we know a
-    // checkmate is possible.
-    if (w_pawn_bitboard != 0 || b_pawn_bitboard != 0 ||
-        w_rook_bitboard != 0 || b_rook_bitboard != 0 ||
-        w_queen_bitboard != 0 || b_queen_bitboard != 0)
+    for (const auto &bitboards : position.piece_bitboards)
     {
-        return false;
-    }
+        const Bitboard knights =
+                bitboards[static_cast<unsigned>(Piece_type::knight)];
+        const Bitboard bishops =
+                bitboards[static_cast<unsigned>(Piece_type::bishop)];
+
+        // If any pawns, rooks, or queens exist on the board, we know a
+        // checkmate is possible.
+        if (bitboards[static_cast<unsigned>(Piece_type::pawn)] != 0 ||
+            bitboards[static_cast<unsigned>(Piece_type::rook)] != 0 ||
+            bitboards[static_cast<unsigned>(Piece_type::queen)] != 0)
+        {
+            return false;
+        }
 
-    // If a player has 2 bishops of different square colors, a checkmate is
-    // possible.
-    if (((w_bishop_bitboard & white_squares) != 0 &&
-         (w_bishop_bitboard & black_squares) != 0) ||
-        ((b_bishop_bitboard & white_squares) != 0 &&
-         (b_bishop_bitboard & black_squares) != 0))
-    {
-        return false;
-    }
+        // If a player has 2 bishops of different square colors, a checkmate
+        // is possible.
+        if ((bishops & white_squares) != 0 && (bishops & black_squares) != 0)
+        {
+            return false;
+        }
 
-    // If a player has 2 knights, a checkmate is possible.
-    if (count_bits_set(w_knight_bitboard) > 1 ||
-        count_bits_set(b_knight_bitboard) > 1)
-    {
-        return false;
-    }
+        // If a player has 2 knights, a checkmate is possible.
+        if (count_bits_set(knights) > 1)
+        {
+            return false;
+        }
 
-    // If a player has a knight and a bishop, a checkmate is possible.
-    if ((w_knight_bitboard != 0 && w_bishop_bitboard != 0) ||
-        (b_knight_bitboard != 0 && b_bishop_bitboard != 0))
-    {
-        return false;
+        // If a player has a knight and a bishop, a checkmate is possible.
+        if (knights != 0 && bishops != 0)
+        {
+            return false;
+        }
     }
 
     // If none of the above conditions are met, we can assume that a checkmate
@@ -179,7 +103,7 @@ bool Game::insufficient_material() const
 // Checks if the specified square is occupied.
 bool Game::is_occupied(const Square square) const
 {
-    return (square_to_bb(square) & all_bitboard) != 0;
+    return (square_to_bb(square) & all_pieces()) != 0;
 }
 
 
@@ -187,42 +111,22 @@ bool Game::is_occupied(const Square square) const
 // color.
 bool Game::is_occupied(const Square square, const Color color) const
 {
-    if (color == Color::white)
-    {
-        return (square_to_bb(square) & white_bitboard) != 0;
-    }
-    else
-    {
-        return (square_to_bb(square) & black_bitboard) != 0;
-    }
+    return (square_to_bb(square) & pieces_of(color)) != 0;
 }
 
 
-// Using a list of possible moves, checks if the game has ended, and if
-// so, why.
-Game_state Game::game_state(const std::vector<Move> &possible_moves)
+// Using the list of legal moves for the current position, checks if the
+// game has ended, and if so, why.
+Game_state Game::game_state(const Move_list &possible_moves)
 {
-    bool legal_moves_exist = false;
-
-    // Check if any legal moves exist.
-    for (auto const move : possible_moves)
-    {
-        if(make_move(move))
-        {
-            undo();
-            legal_moves_exist = true;
-            break;
-        }
-    }
-
     // No legal moves for the current player means the game has ended in
     // either a checkmate or stalemate.
-    if (!legal_moves_exist)
+    if (possible_moves.empty())
     {
         // If the current player's king is also in check, it is a checkmate.
-        if (king_in_check(turn))
+        if (in_check())
         {
-            if (turn == Color::white)
+            if (position.turn == Color::white)
             {
                 return Game_state::checkmate_by_black;
             }
@@ -238,16 +142,56 @@ Game_state Game::game_state(const std::vector<Move> &possible_moves)
         }
     }
 
-    // If the same position has occurred three times in the past, this is a
+    // A game is only drawn once the same position has occurred three times.
+    return draw_state(2);
+}
+
+
+// Checks if the current position has occurred the specified number of times
+// before since the last irreversible move.
+bool Game::is_repetition(const unsigned times) const
+{
+    const Bitstring key = hash();
+
+    // A position from before the last pawn move or capture can never occur
+    // again, and one from before a null move is not counted, so the scan
+    // stops at whichever came last. Only every other position has the same
+    // player to move. There are never more plies since the last null move
+    // than entries in the history.
+    const unsigned plies = std::min<unsigned>(
+            position.rule50,
+            plies_from_null
+    );
+    unsigned count = 0;
+
+    for (unsigned ply = 2; ply <= plies; ply += 2)
+    {
+        if (history[history.size() - ply].key == key && ++count == times)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+// Checks if the game has ended in a draw by repetition, the 50-move rule or
+// insufficient material. The position must have occurred the specified
+// number of times before to be a draw by repetition. Checkmate and stalemate
+// are not checked.
+Game_state Game::draw_state(const unsigned repetitions) const
+{
+    // If the same position has occurred enough times in the past, this is a
     // draw.
-    if (history.back().threefold_repetition)
+    if (is_repetition(repetitions))
     {
         return Game_state::threefold_repetition;
     }
 
     // If 50 moves (100 plies) have been played with no pawn movements or
     // piece captures, this is a draw.
-    if (rule50 >= 100)
+    if (position.rule50 >= 100)
     {
         return Game_state::fifty_move;
     }
@@ -267,109 +211,229 @@ Game_state Game::game_state(const std::vector<Move> &possible_moves)
 // Checks if the game has ended, and if so, why.
 Game_state Game::game_state()
 {
-    return game_state(pseudo_legal_moves());
+    return game_state(legal_moves());
 }
 
 
-// Checks if the specified square is under attack by a specified player.
-bool Game::square_attacked(const Square square, const Color attacker)
+// Returns a bitboard of all the pieces of both colors that attack the
+// specified square when the board has the specified occupancy.
+Bitboard Game::attackers_to(
+        const Square square,
+        const Bitboard occupancy
+) const
 {
-    bool attacker_is_opponent = false;
+    const auto index = static_cast<unsigned>(square);
+
+    const Bitboard bishops_queens =
+            pieces_of(Color::white, Piece_type::bishop, Piece_type::queen) |
+            pieces_of(Color::black, Piece_type::bishop, Piece_type::queen);
+    const Bitboard rooks_queens =
+            pieces_of(Color::white, Piece_type::rook, Piece_type::queen) |
+            pieces_of(Color::black, Piece_type::rook, Piece_type::queen);
+    const Bitboard knights = pieces_of(Color::white, Piece_type::knight) |
+                             pieces_of(Color::black, Piece_type::knight);
+    const Bitboard kings = pieces_of(Color::white, Piece_type::king) |
+                           pieces_of(Color::black, Piece_type::king);
+
+    // A white pawn attacks the square from the same squares a black pawn on
+    // it would attack, and vice versa.
+    const Bitboard w_pawn_attackers =
+            b_pawn_attacks[index] & pieces_of(Color::white, Piece_type::pawn);
+    const Bitboard b_pawn_attackers =
+            w_pawn_attacks[index] & pieces_of(Color::black, Piece_type::pawn);
+
+    return w_pawn_attackers | b_pawn_attackers |
+           (knight_attacks[index] & knights) |
+           (king_attacks[index] & kings) |
+           (bishop_attacks(square, occupancy) & bishops_queens) |
+           (rook_attacks(square, occupancy) & rooks_queens);
+}
 
-    // If the attacker is not playing this turn, switch sides so that moves
-    // can be generated for them.
-    if (turn != attacker)
+
+// Returns a bitboard of all the squares attacked by a player when the board
+// has the specified occupancy.
+template <Color attacker>
+Bitboard Game::attacked_squares(const Bitboard occupancy) const
+{
+    const Bitboard pawns = pieces_of(attacker, Piece_type::pawn);
+    Bitboard knights = pieces_of(attacker, Piece_type::knight);
+    Bitboard bishops_queens = pieces_of(
+            attacker,
+            Piece_type::bishop,
+            Piece_type::queen
+    );
+    Bitboard rooks_queens = pieces_of(
+            attacker,
+            Piece_type::rook,
+            Piece_type::queen
+    );
+    const Bitboard king = pieces_of(attacker, Piece_type::king);
+
+    // The pawns attack all at once.
+    Bitboard attacked = shift_forward_east<attacker>(pawns) |
+                        shift_forward_west<attacker>(pawns) |
+                        king_attacks[set_bit_pos(king)];
+
+    while (knights != 0)
+    {
+        attacked |= knight_attacks[static_cast<unsigned>(pop_lsb(knights))];
+    }
+    while (bishops_queens != 0)
+    {
+        attacked |= bishop_attacks(pop_lsb(bishops_queens), occupancy);
+    }
+    while (rooks_queens != 0)
     {
-        attacker_is_opponent = true;
-        end_turn();
+        attacked |= rook_attacks(pop_lsb(rooks_queens), occupancy);
     }
 
-    std::vector<Move> possible_moves = pseudo_legal_moves();
+    return attacked;
+}
+
+
+// Returns the square a player's king is on.
+template <Color color>
+Square Game::king_square() const
+{
+    return static_cast<Square>(set_bit_pos(
+            pieces_of(color, Piece_type::king)
+    ));
+}
+
 
-    // Go through each possible move for the attacker to check if the
-    // specified square is under attack.
-    for (auto const move : possible_moves)
+// Returns a bitboard of the pieces belonging to a player that are pinned to
+// their king.
+template <Color color>
+Bitboard Game::pinned_pieces(const Square king_sq) const
+{
+    constexpr Color enemy = reverse_color(color);
+
+    const Bitboard own_bitboard = pieces_of(color);
+    const Bitboard enemy_bitboard = pieces_of(enemy);
+    const Bitboard enemy_bishops_queens = pieces_of(
+            enemy,
+            Piece_type::bishop,
+            Piece_type::queen
+    );
+    const Bitboard enemy_rooks_queens = pieces_of(
+            enemy,
+            Piece_type::rook,
+            Piece_type::queen
+    );
+
+    // Find the enemy sliders that would attack the king if none of the
+    // friendly pieces were on the board.
+    Bitboard snipers =
+            (bishop_attacks(king_sq, enemy_bitboard) & enemy_bishops_queens) |
+            (rook_attacks(king_sq, enemy_bitboard) & enemy_rooks_queens);
+
+    Bitboard pinned = 0;
+
+    // A friendly piece is pinned if it is the only piece between the king
+    // and one of those sliders.
+    while (snipers != 0)
     {
-        if (extract_dest_sq(move) == square)
+        const Square sniper_sq = pop_lsb(snipers);
+        const Bitboard blockers = squares_between(king_sq, sniper_sq) &
+                                  all_pieces();
+
+        if (count_bits_set(blockers) == 1)
         {
-            if (attacker_is_opponent)
-            {
-                end_turn();
-            }
-            return true;
+            pinned |= blockers & own_bitboard;
         }
     }
 
-    // Switch the sides back.
-    if (attacker_is_opponent)
-    {
-        end_turn();
-    }
+    return pinned;
+}
 
-    return false;
+
+// Checks if the specified square is under attack by a player.
+template <Color attacker>
+bool Game::square_attacked(const Square square) const
+{
+    return on_bitboard(attackers_to(square, all_pieces()), pieces_of(attacker));
 }
 
 
 // Checks if the specified player's king is in check.
-bool Game::king_in_check(const Color color)
+bool Game::king_in_check(const Color color) const
 {
-    // Find the square the king is on.
-    Square king_square;
     if (color == Color::white)
     {
-        king_square = static_cast<Square>(set_bit_pos(w_king_bitboard));
+        return square_attacked<Color::black>(king_square<Color::white>());
     }
     else
     {
-        king_square = static_cast<Square>(set_bit_pos(b_king_bitboard));
+        return square_attacked<Color::white>(king_square<Color::black>());
     }
+}
+
 
-    // Check if the square is under attack by the other player.
-    return square_attacked(king_square, reverse_color(color));
+// Checks if the player to move is in check.
+bool Game::in_check() const
+{
+    return check_info.checkers != 0;
 }
 
 
-// Returns the FEN representation of the board.
-std::string Game::fen() const
+// Computes the checkers and pinned pieces of the current position, in which
+// the specified player is to move.
+template <Color color>
+void Game::update_check_info()
 {
-    std::string fen_str;
+    const Square king_sq = king_square<color>();
+
+    check_info.checkers = attackers_to(king_sq, all_pieces()) &
+                          pieces_of(reverse_color(color));
+    check_info.pinned = pinned_pieces<color>(king_sq);
+}
+
 
-    // Generate an FEN string for each row.
-    for (auto row = 7; row >= 0; row--)
+// Computes the checkers and pinned pieces of the current position.
+void Game::update_check_info()
+{
+    if (position.turn == Color::white)
     {
-        // Go through each square in this row.
-        for (auto position = row * 8; position < ((row + 1) * 8); position++)
-        {
-            const Piece piece = piece_on(static_cast<Square>(position));
-            // If a piece is on this square, append the FEN representation of
-            // this piece to the string.
-            if (piece != Piece::none)
-            {
-                fen_str += piece_fen[piece];
-            }
-            // If there is no piece on this square, a "1" should be added
-            // instead, unless a number is already at the end of the string,
-            // then that number should be incremented by 1.
-            else
-            {
-                const char last_char = fen_str.back();
-                // Add 1 to the last character if it is a number.
-                if (isdigit(last_char))
-                {
-                    fen_str.back()++;
-                }
-                // Otherwise, add a "1" to the end of the string.
-                else
-                {
-                    fen_str += "1";
-                }
-            }
-        }
-        // Add a slash to the end for each row.
-        fen_str += "/";
+        update_check_info<Color::white>();
+    }
+    else
+    {
+        update_check_info<Color::black>();
     }
-    // Remove the slash at the end.
-    fen_str.pop_back();
+}
+
+
+// The move generator needs both colors of the templated queries.
+template Bitboard Game::attacked_squares<Color::white>(const Bitboard) const;
+template Bitboard Game::attacked_squares<Color::black>(const Bitboard) const;
+template Square Game::king_square<Color::white>() const;
+template Square Game::king_square<Color::black>() const;
+template Bitboard Game::pinned_pieces<Color::white>(const Square) const;
+template Bitboard Game::pinned_pieces<Color::black>(const Square) const;
+template bool Game::square_attacked<Color::white>(const Square) const;
+template bool Game::square_attacked<Color::black>(const Square) const;
+template void Game::update_check_info<Color::white>();
+template void Game::update_check_info<Color::black>();
+
+
+// Returns the bitboards of the pieces on the board, so that the attacks of
+// many positions can be computed at once with batch_attacks().
+Board_bitboards Game::board_bitboards() const
+{
+    return {position.piece_bitboards};
+}
+
+
+// Returns the squares attacked by each player and their mobility. This
+// computes one position with the attack tables, like the move generator does.
+Board_attacks Game::board_attacks() const
+{
+    Board_attacks attacks;
+
+    attacks.attacked[0] = attacked_squares<Color::white>(all_pieces());
+    attacks.attacked[1] = attacked_squares<Color::black>(all_pieces());
+    attacks.mobility[0] = attacks.attacked[0] & ~pieces_of(Color::white);
+    attacks.mobility[1] = attacks.attacked[1] & ~pieces_of(Color::black);
 
-    return fen_str;
+    return attacks;
 }
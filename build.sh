@@ -1,4 +1,4 @@
 #!/bin/bash
 swig -c++ -python chessbot.i 
-g++ -fPIC -c *.h *.cpp lib/*.h lib/*.cpp -I/usr/include/python3.6
-gcc -shared *.o -o _chessbot.so -lstdc++
+g++ -std=c++20 -fPIC -pthread -c *.h *.cpp -I/usr/include/python3.6
+gcc -shared -pthread *.o -o _chessbot.so -lstdc++
@@ -1,13 +1,16 @@
 %module chessbot
 %include "std_string.i"
+%include "std_except.i"
 %include "types.h"
 %import "utils.h"
 
 %{
 #include "game.h"
-#include "lib/magicmoves.h"
+#include "game_pool.h"
 %}
 
-%include "game.h"
+// An invalid FEN is raised as a ValueError in Python.
+%catches(std::invalid_argument) Game::Game(const std::string &fen);
 
-extern void initmagicmoves(void);
+%include "game.h"
+%include "game_pool.h"
@@ -6,7 +6,7 @@
 
 // Piece-square tables - from http://www.chessbin.com/post/Piece-Square-Table.aspx
 
-const std::array<int, 64> pawn_pst =
+constexpr std::array<int, 64> pawn_pst =
 {
       0,   0,   0,   0,   0,   0,   0,   0,
     105, 110, 110,  75,  75, 110, 110, 105,
@@ -18,7 +18,7 @@ const std::array<int, 64> pawn_pst =
       0,   0,   0,   0,   0,   0,   0,   0
 };
 
-const std::array<int, 64> knight_pst =
+constexpr std::array<int, 64> knight_pst =
 {
     250, 260, 280, 270, 270, 280, 260, 250,
     260, 280, 300, 305, 305, 300, 280, 260,
@@ -30,7 +30,7 @@ const std::array<int, 64> knight_pst =
     250, 260, 270, 270, 270, 270, 260, 250
 };
 
-const std::array<int, 64> bishop_pst =
+constexpr std::array<int, 64> bishop_pst =
 {
     305, 315, 285, 315, 315, 285, 315, 305,
     315, 330, 325, 325, 325, 325, 330, 335,
@@ -42,7 +42,7 @@ const std::array<int, 64> bishop_pst =
     305, 315, 315, 315, 315, 315, 315, 305
 };
 
-const std::array<int, 64> rook_pst =
+constexpr std::array<int, 64> rook_pst =
 {
     500, 500, 500, 500, 500, 500, 500, 500,
     500, 500, 500, 500, 500, 500, 500, 500,
@@ -54,7 +54,7 @@ const std::array<int, 64> rook_pst =
     500, 500, 500, 500, 500, 500, 500, 500
 };
 
-const std::array<int, 64> queen_pst =
+constexpr std::array<int, 64> queen_pst =
 {
     900, 900, 900, 900, 900, 900, 900, 900,
     900, 900, 900, 900, 900, 900, 900, 900,
@@ -66,7 +66,7 @@ const std::array<int, 64> queen_pst =
     900, 900, 900, 900, 900, 900, 900, 900
 };
 
-const std::array<int, 64> king_pst =
+constexpr std::array<int, 64> king_pst =
 {
     20,   30,  10,   0,   0,  10,  30,  20,
     20,   20,   0,   0,   0,   0,  20,  20,
@@ -79,7 +79,7 @@ const std::array<int, 64> king_pst =
 };
 
 // Used to flip the board for black pieces.
-const std::array<int, 64> flip =
+constexpr std::array<int, 64> flip =
 {
     56,  57,  58,  59,  60,  61,  62,  63,
     48,  49,  50,  51,  52,  53,  54,  55,
@@ -92,15 +92,54 @@ const std::array<int, 64> flip =
 };
 
 
+// The piece-square tables indexed by piece type.
+constexpr std::array<std::array<int, 64>, 6> piece_square_tables =
+{
+    pawn_pst,
+    knight_pst,
+    bishop_pst,
+    rook_pst,
+    queen_pst,
+    king_pst
+};
+
+
+// Generates the evaluation of every piece on every square, indexed by color,
+// piece type and square. Black pieces have a negated evaluation, and the
+// board is flipped when evaluating them.
+constexpr std::array<std::array<std::array<int, 64>, 6>, 2>
+gen_piece_square_values()
+{
+    std::array<std::array<std::array<int, 64>, 6>, 2> values{};
+
+    for (unsigned type = 0; type < 6; type++)
+    {
+        for (unsigned square = 0; square < 64; square++)
+        {
+            values[0][type][square] = piece_square_tables[type][square];
+            values[1][type][square] =
+                    -piece_square_tables[type][flip[square]];
+        }
+    }
+
+    return values;
+}
+
+const auto piece_square_values = gen_piece_square_values();
+
+
  // Initializes the evaluation variable.
 void Game::init_eval()
 {
-    evaluation = 0;
+    position.evaluation = 0;
+
+    // Add up the evaluation of all the pieces. Empty squares evaluate to 0.
+    Bitboard occupied = all_pieces();
 
-    // Add up the evaluation of all the pieces.
-    for (auto square_index = 0; square_index < 64; square_index++)
+    while (occupied != 0)
     {
-        evaluation += eval_square(static_cast<Square>(square_index));
+        const Square square = pop_lsb(occupied);
+        position.evaluation += eval_piece(piece_on(square), square);
     }
 }
 
@@ -108,59 +147,15 @@ void Game::init_eval()
 // Obtains the evaluation of the board in its current state.
 int Game::evaluate() const
 {
-      return evaluation;
+      return position.evaluation;
 }
 
 
-// Uses piece-square tables to evaluate a square.
-int Game::eval_square(const Square square) const
+// Uses piece-square tables to evaluate a piece on a square. The piece must
+// not be none.
+int Game::eval_piece(const Piece piece, const Square square) const
 {
-    const Piece piece = piece_on(square);
-    const Color color = piece_color(piece);
-    const int *piece_square_table = nullptr;
-
-    // Obtain the appropriate piece-square table.
-    switch (piece)
-    {
-        case Piece::none:
-            return 0;
-        case Piece::w_pawn:
-        case Piece::b_pawn:
-            piece_square_table = pawn_pst.data();
-            break;
-        case Piece::w_knight:
-        case Piece::b_knight:
-            piece_square_table = knight_pst.data();
-            break;
-        case Piece::w_bishop:
-        case Piece::b_bishop:
-            piece_square_table = bishop_pst.data();
-            break;
-        case Piece::w_rook:
-        case Piece::b_rook:
-            piece_square_table = rook_pst.data();
-            break;
-        case Piece::w_queen:
-        case Piece::b_queen:
-            piece_square_table = queen_pst.data();
-            break;
-        case Piece::w_king:
-        case Piece::b_king:
-            piece_square_table = king_pst.data();
-            break;
-    }
-
-    // Use the value of the square in the piece-square table as the
-    // evaluation.
-    if (color == Color::white)
-    {
-        return piece_square_table[static_cast<unsigned>(square)];
-    }
-    // Black pieces have a negated evaluation, and the board should be
-    // flipped when evaluating them.
-    else
-    {
-        return -piece_square_table[flip[static_cast<unsigned>(square)]];
-    }
+    return piece_square_values[piece_color_index(piece)][
+            piece_type_index(piece)
+    ][static_cast<unsigned>(square)];
 }
-
@@ -0,0 +1,458 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <limits>
+#include <string>
+#include "types.h"
+#include "utils.h"
+#include "game.h"
+
+
+// The FEN character of each piece, indexed by piece.
+constexpr std::array<char, 13> piece_chars =
+{
+    ' ', 'P', 'N', 'B', 'R', 'Q', 'K', 'p', 'n', 'b', 'r', 'q', 'k'
+};
+
+// A castling right with its FEN character, and the player and squares of the
+// king and rook it needs.
+struct Castling_fen
+{
+    Castling_right right;
+    char fen_char;
+    Color color;
+    Square king_sq;
+    Square rook_sq;
+};
+
+// The castling rights in the order they are written in a FEN.
+constexpr std::array<Castling_fen, 4> castling_fens =
+{{
+    {Castling_right::w_kingside, 'K', Color::white, Square::E1, Square::H1},
+    {Castling_right::w_queenside, 'Q', Color::white, Square::E1, Square::A1},
+    {Castling_right::b_kingside, 'k', Color::black, Square::E8, Square::H8},
+    {Castling_right::b_queenside, 'q', Color::black, Square::E8, Square::A8}
+}};
+
+// The length of a FEN with a piece on every square, every castling right and
+// the longest numbers.
+const unsigned max_fen_length = 71 + 8 + 5 + 1 + 10 + 1;
+
+// The largest fullmove number whose number of plies still fits in an
+// unsigned integer.
+const unsigned max_fullmove = std::numeric_limits<unsigned>::max() / 2;
+
+// Bitboards of the first and last rows, where no pawn can stand.
+const Bitboard back_rows = 0xFF000000000000FF;
+
+
+// Returns the piece written as a character in a FEN, or none if the
+// character is not a piece.
+Piece char_to_piece(const char fen_char)
+{
+    for (unsigned piece = 1; piece < piece_chars.size(); piece++)
+    {
+        if (piece_chars[piece] == fen_char)
+        {
+            return static_cast<Piece>(piece);
+        }
+    }
+
+    return Piece::none;
+}
+
+
+// Reads a number at the start of the characters and moves past it. Returns
+// false if there is no number or it does not fit.
+bool read_number(const char *&current, const char *end, unsigned &number)
+{
+    const auto [next, error] = std::from_chars(current, end, number);
+
+    if (error != std::errc())
+    {
+        return false;
+    }
+
+    current = next;
+    return true;
+}
+
+
+// Returns the number of pieces on a bitboard beyond the number a player
+// starts with.
+int extra_pieces(const Bitboard pieces, const int initial_count)
+{
+    return std::max(std::popcount(pieces) - initial_count, 0);
+}
+
+
+// Sets up the position and the first ply from a FEN string. Returns false if
+// the FEN is invalid, in which case the position is left partially set up.
+bool Game::parse_fen(const std::string &fen)
+{
+    const char *current = fen.data();
+    const char *const end = current + fen.size();
+
+    position = Position{};
+    position.en_passant_square = Square::none;
+
+    // Piece placement, from the 8th row to the 1st and from column A to H
+    // in each row.
+    int row = 7;
+    int col = 0;
+
+    for (; current != end && *current != ' '; current++)
+    {
+        if (*current >= '1' && *current <= '8')
+        {
+            // Consecutive empty squares are written as a single digit.
+            if (current + 1 != end && current[1] >= '1' && current[1] <= '8')
+            {
+                return false;
+            }
+
+            col += *current - '0';
+        }
+        else if (*current == '/')
+        {
+            if (col != 8 || row == 0)
+            {
+                return false;
+            }
+
+            row--;
+            col = 0;
+            continue;
+        }
+        else
+        {
+            const Piece piece = char_to_piece(*current);
+
+            if (piece == Piece::none || col >= 8)
+            {
+                return false;
+            }
+
+            add_piece(piece, static_cast<Square>(row * 8 + col));
+            col++;
+        }
+
+        if (col > 8)
+        {
+            return false;
+        }
+    }
+
+    if (row != 0 || col != 8)
+    {
+        return false;
+    }
+
+    // Player to move
+    if (end - current < 2 || current[0] != ' ')
+    {
+        return false;
+    }
+
+    if (current[1] == 'w')
+    {
+        position.turn = Color::white;
+    }
+    else if (current[1] == 'b')
+    {
+        position.turn = Color::black;
+    }
+    else
+    {
+        return false;
+    }
+
+    current += 2;
+
+    // Castling rights
+    if (end - current < 2 || current[0] != ' ')
+    {
+        return false;
+    }
+
+    current++;
+    unsigned castling_rights = 0;
+
+    if (*current == '-')
+    {
+        current++;
+    }
+    else
+    {
+        // The field is '-' when there are no castling rights, so it can not
+        // be empty.
+        if (*current == ' ')
+        {
+            return false;
+        }
+
+        for (; current != end && *current != ' '; current++)
+        {
+            unsigned right = 0;
+
+            for (const auto &castling_fen : castling_fens)
+            {
+                if (castling_fen.fen_char == *current)
+                {
+                    right = static_cast<unsigned>(castling_fen.right);
+                }
+            }
+
+            if (right == 0 || (castling_rights & right) != 0)
+            {
+                return false;
+            }
+
+            castling_rights |= right;
+        }
+    }
+
+    // A castling right is dropped if its king or rook has moved, since
+    // castling moves are generated without checking for the pieces.
+    for (const auto &castling_fen : castling_fens)
+    {
+        const Color color = castling_fen.color;
+
+        if (piece_on(castling_fen.king_sq) !=
+                    make_piece(color, Piece_type::king) ||
+            piece_on(castling_fen.rook_sq) !=
+                    make_piece(color, Piece_type::rook))
+        {
+            castling_rights &= ~static_cast<unsigned>(castling_fen.right);
+        }
+    }
+
+    position.castling_rights = static_cast<Castling_right>(castling_rights);
+
+    // En passant square
+    if (end - current < 2 || current[0] != ' ')
+    {
+        return false;
+    }
+
+    current++;
+
+    if (*current == '-')
+    {
+        current++;
+    }
+    else
+    {
+        if (end - current < 2 || current[0] < 'a' || current[0] > 'h')
+        {
+            return false;
+        }
+
+        // The square is behind a pawn of the player who is not to move,
+        // which has just moved two squares from its initial square.
+        const Color pusher = reverse_color(position.turn);
+        const int ep_row = pusher == Color::white ? 2 : 5;
+        const int pawn_row = pusher == Color::white ? 3 : 4;
+        const int initial_row = pusher == Color::white ? 1 : 6;
+        const int ep_col = current[0] - 'a';
+
+        if (current[1] != '1' + ep_row ||
+            piece_on(static_cast<Square>(pawn_row * 8 + ep_col)) !=
+                    make_piece(pusher, Piece_type::pawn) ||
+            piece_on(static_cast<Square>(ep_row * 8 + ep_col)) !=
+                    Piece::none ||
+            piece_on(static_cast<Square>(initial_row * 8 + ep_col)) !=
+                    Piece::none)
+        {
+            return false;
+        }
+
+        position.en_passant_square = static_cast<Square>(ep_row * 8 + ep_col);
+        current += 2;
+    }
+
+    // Halfmove clock and fullmove number, which are optional.
+    unsigned rule50 = 0;
+    unsigned fullmove = 1;
+
+    if (current != end)
+    {
+        if (*current != ' ')
+        {
+            return false;
+        }
+
+        current++;
+
+        if (!read_number(current, end, rule50) || rule50 > 0xFFFF ||
+            current == end || *current != ' ')
+        {
+            return false;
+        }
+
+        current++;
+
+        if (!read_number(current, end, fullmove) || fullmove == 0 ||
+            fullmove > max_fullmove || current != end)
+        {
+            return false;
+        }
+    }
+
+    position.rule50 = rule50;
+    first_ply = (fullmove - 1) * 2 + (position.turn == Color::black ? 1 : 0);
+
+    // Each player must have exactly one king, pawns can not be on the first
+    // or last row, and the player who just moved can not be left in check.
+    for (const auto color : {Color::white, Color::black})
+    {
+        if (std::popcount(pieces_of(color, Piece_type::king)) != 1 ||
+            (pieces_of(color, Piece_type::pawn) & back_rows) != 0)
+        {
+            return false;
+        }
+
+        // A player has at most 16 pieces, 8 of them pawns, and each piece
+        // beyond the initial ones is a promoted pawn. This keeps the number
+        // of legal moves within what a move list holds.
+        const int pawns = std::popcount(pieces_of(color, Piece_type::pawn));
+        const int promoted =
+                extra_pieces(pieces_of(color, Piece_type::queen), 1) +
+                extra_pieces(pieces_of(color, Piece_type::rook), 2) +
+                extra_pieces(pieces_of(color, Piece_type::bishop), 2) +
+                extra_pieces(pieces_of(color, Piece_type::knight), 2);
+
+        if (std::popcount(pieces_of(color)) > 16 || pawns > 8 ||
+            promoted > 8 - pawns)
+        {
+            return false;
+        }
+    }
+
+    if (king_in_check(reverse_color(position.turn)))
+    {
+        return false;
+    }
+
+    init_hash();
+    init_eval();
+    update_check_info();
+
+    return true;
+}
+
+
+// Sets up the position from a FEN string and clears the history. All six
+// fields are read, but the halfmove clock and fullmove number may be left
+// out. Returns false and leaves the game unchanged if the FEN is invalid.
+bool Game::set_fen(const std::string &fen)
+{
+    const Position old_position = position;
+    const unsigned old_first_ply = first_ply;
+
+    if (!parse_fen(fen))
+    {
+        position = old_position;
+        first_ply = old_first_ply;
+
+        return false;
+    }
+
+    history.clear();
+    plies_from_null = 0;
+
+    return true;
+}
+
+
+// Returns the FEN representation of the position, with all six fields.
+std::string Game::fen() const
+{
+    // The longest possible FEN fits, so the string is only allocated once.
+    std::string fen_str;
+    fen_str.reserve(max_fen_length);
+
+    // Piece placement, from the 8th row to the 1st. Consecutive empty
+    // squares are written as a single number.
+    for (int row = 7; row >= 0; row--)
+    {
+        char empty_squares = 0;
+
+        for (int col = 0; col < 8; col++)
+        {
+            const Piece piece = piece_on(static_cast<Square>(row * 8 + col));
+
+            if (piece == Piece::none)
+            {
+                empty_squares++;
+                continue;
+            }
+
+            if (empty_squares != 0)
+            {
+                fen_str += '0' + empty_squares;
+                empty_squares = 0;
+            }
+
+            fen_str += piece_chars[static_cast<unsigned>(piece)];
+        }
+
+        if (empty_squares != 0)
+        {
+            fen_str += '0' + empty_squares;
+        }
+
+        fen_str += row == 0 ? ' ' : '/';
+    }
+
+    fen_str += position.turn == Color::white ? 'w' : 'b';
+    fen_str += ' ';
+
+    if (position.castling_rights == Castling_right::no_castling)
+    {
+        fen_str += '-';
+    }
+
+    for (const auto &castling_fen : castling_fens)
+    {
+        if ((static_cast<unsigned>(position.castling_rights) &
+             static_cast<unsigned>(castling_fen.right)) != 0)
+        {
+            fen_str += castling_fen.fen_char;
+        }
+    }
+
+    fen_str += ' ';
+
+    if (position.en_passant_square == Square::none)
+    {
+        fen_str += '-';
+    }
+    else
+    {
+        const int ep_sq = static_cast<int>(position.en_passant_square);
+        fen_str += 'a' + ep_sq % 8;
+        fen_str += '1' + ep_sq / 8;
+    }
+
+    // The numbers are written without making temporary strings.
+    std::array<char, 24> numbers;
+    char *numbers_end = numbers.data() + numbers.size();
+    char *current = std::to_chars(
+            numbers.data(),
+            numbers_end,
+            position.rule50
+    ).ptr;
+    *current++ = ' ';
+    current = std::to_chars(
+            current,
+            numbers_end,
+            (first_ply + history.size()) / 2 + 1
+    ).ptr;
+
+    fen_str += ' ';
+    fen_str.append(numbers.data(), current);
+
+    return fen_str;
+}
@@ -1,125 +1,68 @@
+#include <stdexcept>
 #include "types.h"
 #include "utils.h"
 #include "game.h"
 
 
-// Initializes Zobrist hashing and the evaluation variable.
+// Initializes the Zobrist key, the evaluation variable and the check
+// information.
 Game::Game()
 {
-    // Initialize variables needed for hashing.
-    init_zobrist();
+    // Initialize the Zobrist key.
     init_hash();
 
     // Initialize the evaluation variable.
     init_eval();
-}
-
-
-// Gets the color of the player who is to play this turn.
-const Color Game::get_turn() const
-{
-    return turn;
-}
-
-
-// Ends the current turn.
-void Game::end_turn()
-{
-    turn = reverse_color(turn);
-}
-
-
-// Determines if white kingside castling has been invalidated.
-bool Game::w_kingside_castling_invalidated() const
-{
-    // Check if the bit for white kingside castling is set.
-    return (static_cast<unsigned>(castling_rights) &
-            static_cast<unsigned>(Castling_right::w_kingside)) == 0;
-}
-
 
-// Determines if white queenside castling has been invalidated.
-bool Game::w_queenside_castling_invalidated() const
-{
-    // Check if the bit for white queenside castling is set.
-    return (static_cast<unsigned>(castling_rights) &
-            static_cast<unsigned>(Castling_right::w_queenside)) == 0;
-}
-
-
-// Determines if black kingside castling has been invalidated.
-bool Game::b_kingside_castling_invalidated() const
-{
-    // Check if the bit for black kingside castling is set.
-    return (static_cast<unsigned>(castling_rights) &
-            static_cast<unsigned>(Castling_right::b_kingside)) == 0;
-}
-
-
-// Determines if white queenside castling has been invalidated.
-bool Game::b_queenside_castling_invalidated() const
-{
-    // Check if the bit for black queenside castling is set.
-    return (static_cast<unsigned>(castling_rights) &
-            static_cast<unsigned>(Castling_right::b_queenside)) == 0;
+    update_check_info();
 }
 
 
-// Invalidates white kingside castling.
-void Game::invalidate_w_kingside_castling()
+// Starts a game from a position in FEN. Throws std::invalid_argument if the
+// FEN is invalid.
+Game::Game(const std::string &fen) : Game()
 {
-    // Unset the bit for white kingside castling.
-    castling_rights = static_cast<Castling_right>(
-             static_cast<unsigned>(castling_rights) &
-            ~static_cast<unsigned>(Castling_right::w_kingside));
+    if (!set_fen(fen))
+    {
+        throw std::invalid_argument("Invalid FEN: " + fen);
+    }
 }
 
 
-// Invalidates white queenside castling.
-void Game::invalidate_w_queenside_castling()
+// Returns a copy of the game, including its history.
+Game Game::clone() const
 {
-    // Unset the bit for white queenside castling.
-    castling_rights = static_cast<Castling_right>(
-             static_cast<unsigned>(castling_rights) &
-            ~static_cast<unsigned>(Castling_right::w_queenside));
+    return *this;
 }
 
 
-// Invalidates white castling.
-void Game::invalidate_white_castling()
+// Puts the game back at the initial position. The memory used by the history
+// is kept, so replaying a game does not need to allocate it again.
+void Game::reset()
 {
-    // Unset the bits for white castling.
-    castling_rights = static_cast<Castling_right>(
-             static_cast<unsigned>(castling_rights) &
-            ~static_cast<unsigned>(Castling_right::white));
-}
-
+    history.clear();
+    killers.clear();
+    plies_from_null = 0;
+    position = start_position;
+    first_ply = 0;
+    nodes = 0;
 
-// Invalidates black kingside castling.
-void Game::invalidate_b_kingside_castling()
-{
-    // Unset the bit for black kingside castling.
-    castling_rights = static_cast<Castling_right>(
-             static_cast<unsigned>(castling_rights) &
-            ~static_cast<unsigned>(Castling_right::b_kingside));
+    init_hash();
+    init_eval();
+    update_check_info();
 }
 
 
-// Invalidates black queenside castling.
-void Game::invalidate_b_queenside_castling()
+// Gets the color of the player who is to play this turn.
+const Color Game::get_turn() const
 {
-    // Unset the bit for black queenside castling.
-    castling_rights = static_cast<Castling_right>(
-             static_cast<unsigned>(castling_rights) &
-            ~static_cast<unsigned>(Castling_right::b_queenside));
+    return position.turn;
 }
 
 
-// Invalidates black castling.
-void Game::invalidate_black_castling()
+// Ends the current turn.
+void Game::end_turn()
 {
-    // Unset the bits for black castling.
-    castling_rights = static_cast<Castling_right>(
-             static_cast<unsigned>(castling_rights) &
-            ~static_cast<unsigned>(Castling_right::black));
+    position.turn = reverse_color(position.turn);
+    position.key ^= hash_black_to_move();
 }
@@ -2,185 +2,120 @@
 #define DISCORD_CHESS_BOT_GAME_H
 #include <array>
 #include <vector>
-#include <unordered_map>
 #include <string>
 #include "types.h"
+#include "utils.h"
+#include "move_list.h"
+#include "position.h"
+#include "batch_attacks.h"
 
 
+// A hash table of perft results, defined in perft_table.h.
+class Perft_table;
+
+// The squares a castling move needs, defined in move_gen.cpp.
+struct Castling_path;
+
 // Represents a chess game
 class Game
 {
+    // The move picker generates moves for the game in stages.
+    friend class Move_picker;
 private:
     // Store data of previous plies to undo moves
     std::vector<Ply_data> history;
 
-    // Keep track of the occurrences of each hash to detect threefold
-    // repetition.
-    std::unordered_map<Bitstring, unsigned> hash_count;
-
-    // Zobrist hash for the piece positions only
-    Bitstring position_hash;
-
-    // Bitstrings for each square/piece combination
-    std::array<Bitstring, 64> w_pawn_bitstrings;
-    std::array<Bitstring, 64> w_knight_bitstrings;
-    std::array<Bitstring, 64> w_bishop_bitstrings;
-    std::array<Bitstring, 64> w_rook_bitstrings;
-    std::array<Bitstring, 64> w_queen_bitstrings;
-    std::array<Bitstring, 64> w_king_bitstrings;
-
-    std::array<Bitstring, 64> b_pawn_bitstrings;
-    std::array<Bitstring, 64> b_knight_bitstrings;
-    std::array<Bitstring, 64> b_bishop_bitstrings;
-    std::array<Bitstring, 64> b_rook_bitstrings;
-    std::array<Bitstring, 64> b_queen_bitstrings;
-    std::array<Bitstring, 64> b_king_bitstrings;
-
-    // Bitstrings for the side to move
-    Bitstring white_bitstring;
-    Bitstring black_bitstring;
-
-    // Bitstrings for each possible combination of castling rights.
-    // 2 possible values ^ 4 castling rights = 16 combinations
-    std::array<Bitstring, 16> castling_bitstrings;
-
-    // Bitstrings for the en passant squares.
-    std::array<Bitstring, 64> en_passant_bitstrings;
-
-    // Bitboards - White
-    Bitboard w_pawn_bitboard   = 0xFF00;
-    Bitboard w_knight_bitboard = 0x0042;
-    Bitboard w_bishop_bitboard = 0x0024;
-    Bitboard w_rook_bitboard   = 0x0081;
-    Bitboard w_queen_bitboard  = 0x0008;
-    Bitboard w_king_bitboard   = 0x0010;
-
-    // White occupancy bitboard
-    Bitboard white_bitboard    = w_pawn_bitboard |
-                                 w_knight_bitboard |
-                                 w_bishop_bitboard |
-                                 w_rook_bitboard |
-                                 w_queen_bitboard |
-                                 w_king_bitboard;
-
-    // Bitboards - Black
-    Bitboard b_pawn_bitboard   = 0x00FF000000000000;
-    Bitboard b_knight_bitboard = 0x4200000000000000;
-    Bitboard b_bishop_bitboard = 0x2400000000000000;
-    Bitboard b_rook_bitboard   = 0x8100000000000000;
-    Bitboard b_queen_bitboard  = 0x0800000000000000;
-    Bitboard b_king_bitboard   = 0x1000000000000000;
-
-    // Black occupancy bitboard
-    Bitboard black_bitboard    = b_pawn_bitboard |
-                                 b_knight_bitboard |
-                                 b_bishop_bitboard |
-                                 b_rook_bitboard |
-                                 b_queen_bitboard |
-                                 b_king_bitboard;
-
-    // General occupancy bitboard
-    Bitboard all_bitboard = white_bitboard | black_bitboard;
-
-
-    std::array<Piece, 64> pieces_on_board =
-    {
-        Piece::w_rook, Piece::w_knight, Piece::w_bishop, Piece::w_queen, Piece::w_king, Piece::w_bishop, Piece::w_knight, Piece::w_rook,
-        Piece::w_pawn,   Piece::w_pawn,   Piece::w_pawn,  Piece::w_pawn, Piece::w_pawn,   Piece::w_pawn,   Piece::w_pawn, Piece::w_pawn,
-          Piece::none,     Piece::none,     Piece::none,    Piece::none,   Piece::none,     Piece::none,     Piece::none,   Piece::none,
-          Piece::none,     Piece::none,     Piece::none,    Piece::none,   Piece::none,     Piece::none,     Piece::none,   Piece::none,
-          Piece::none,     Piece::none,     Piece::none,    Piece::none,   Piece::none,     Piece::none,     Piece::none,   Piece::none,
-          Piece::none,     Piece::none,     Piece::none,    Piece::none,   Piece::none,     Piece::none,     Piece::none,   Piece::none,
-        Piece::b_pawn,   Piece::b_pawn,   Piece::b_pawn,  Piece::b_pawn, Piece::b_pawn,   Piece::b_pawn,   Piece::b_pawn, Piece::b_pawn,
-        Piece::b_rook, Piece::b_knight, Piece::b_bishop, Piece::b_queen, Piece::b_king, Piece::b_bishop, Piece::b_knight, Piece::b_rook
-    };
-
-    // The square a pawn would end up if it performed en passant.
-    // If the last move was not a 2-square pawn move, the value of this is none.
-    Square en_passant_square = Square::none;
-
-    // Number of plies that have elapsed since a pawn was moved or a piece was
-    // captured. Used for the 50-move rule.
-    unsigned rule50 = 0;
-
-    // The evaluation of the board calculated using piece-square tables.
-    int evaluation;
-
-    // Only the least significant 4 bits are used.
-    // Bit 0: white kingside castle
-    // Bit 1: white queenside castle
-    // Bit 2: black kingside castle
-    // Bit 3: black queenside castle
-    // Bits that are turned on represent castles that have not yet been
-    // permanently invalidated. This is initially set to 15 such that all 4
-    // bits are on.
-    Castling_right castling_rights = Castling_right::all_castling;
-
-    // The color of the player who is to play this turn.
-    Color turn = Color::white;
-
-    // Initializes the random bitstrings require for Zobrist hashing.
-    void init_zobrist();
-
-    // Initializes the Zobrist hash for the piece positions.
-    void init_hash();
+    // The state of the board.
+    Position position = start_position;
 
-    // Initializes the evaluation variable.
-    void init_eval();
+    // Number of plies played before the position the game started from. Used
+    // for the fullmove number of the FEN.
+    unsigned first_ply = 0;
 
-    // Returns the bitstring for a square.
-    Bitstring hash_square(Square square) const;
+    // Number of plies made since the last null move, or since the game
+    // started if there is none. A position from before a null move is never
+    // counted as repeated.
+    unsigned plies_from_null = 0;
 
-    // Generates the Zobrist key for the current position.
-    Bitstring hash() const;
+    // The checkers and pinned pieces of the current position. This is kept
+    // outside of the position so that a position still fits in 3 cache
+    // lines.
+    Check_info check_info = {0, 0};
 
-    // Ends the current turn.
-    void end_turn();
+    // Number of positions visited by the last search.
+    unsigned long long nodes = 0;
 
-    // Checks the origin and destination squares of a move and updates
-    // the castling rights accordingly.
-    void update_castling_rights(const Square origin_sq, const Square dest_sq);
+    // The killer moves for each remaining depth of the current search. These
+    // are quiet moves that caused a beta cutoff in a sibling position.
+    std::vector<std::array<Move, 2>> killers;
 
-    // Determines if white kingside castling has been invalidated.
-    bool w_kingside_castling_invalidated() const;
+    // Sets up the position and the first ply from a FEN string. Returns
+    // false if the FEN is invalid, in which case the position is left
+    // partially set up.
+    bool parse_fen(const std::string &fen);
 
-    // Determines if white queenside castling has been invalidated.
-    bool w_queenside_castling_invalidated() const;
+    // Computes the Zobrist key of the position from scratch.
+    void init_hash();
 
-    // Determines if black kingside castling has been invalidated.
-    bool b_kingside_castling_invalidated() const;
+    // Initializes the evaluation variable.
+    void init_eval();
 
-    // Determines if white queenside castling has been invalidated.
-    bool b_queenside_castling_invalidated() const;
+    // Returns the bitstring of a piece on a square. The piece must not be
+    // none.
+    Bitstring hash_piece(const Piece piece, const Square square) const;
 
-    // Invalidates white kingside castling.
-    void invalidate_w_kingside_castling();
+    // Returns the bitstring that is in the key when black is to move.
+    Bitstring hash_black_to_move() const;
 
-    // Invalidates white queenside castling.
-    void invalidate_w_queenside_castling();
+    // Returns the bitstring of a combination of castling rights.
+    Bitstring hash_castling(const Castling_right castling_rights) const;
 
-    // Invalidates white castling.
-    void invalidate_white_castling();
+    // Returns the bitstring of an en passant square, or 0 if the square is
+    // none.
+    Bitstring hash_en_passant(const Square square) const;
 
-    // Invalidates black kingside castling.
-    void invalidate_b_kingside_castling();
+    // Ends the current turn.
+    void end_turn();
 
-    // Invalidates black queenside castling.
-    void invalidate_b_queenside_castling();
+    // Checks the origin and destination squares of a move and updates
+    // the castling rights accordingly.
+    void update_castling_rights(const Square origin_sq, const Square dest_sq);
 
-    // Invalidates black castling.
-    void invalidate_black_castling();
+    // Returns the bitboard of a player's pieces of the specified type.
+    Bitboard pieces_of(const Color color, const Piece_type type) const
+    {
+        return position.piece_bitboards[color_index(color)][
+                static_cast<unsigned>(type)
+        ];
+    }
+
+    // Returns the bitboard of a player's pieces of either of two types, such
+    // as the bishops and queens that attack along diagonals.
+    Bitboard pieces_of(
+            const Color color,
+            const Piece_type type1,
+            const Piece_type type2
+    ) const
+    {
+        return pieces_of(color, type1) | pieces_of(color, type2);
+    }
 
-    // Returns a reference to the specified piece type's bitboard.
-    Bitboard &get_piece_bitboard(const Piece piece);
+    // Returns the bitboard of all of a player's pieces.
+    Bitboard pieces_of(const Color color) const
+    {
+        return position.color_bitboards[color_index(color)];
+    }
 
-    // Returns a reference to the specified color's bitboard.
-    Bitboard &get_color_bitboard(const Color color);
+    // Returns the bitboard of all the pieces on the board.
+    Bitboard all_pieces() const
+    {
+        return position.color_bitboards[0] | position.color_bitboards[1];
+    }
 
-    // Adds a piece to the specified square.
+    // Adds a piece to the specified square. The piece must not be none.
     void add_piece(const Piece piece, const Square square);
 
-    // Removes a piece from the specified square.
+    // Removes a piece from the specified square. The piece must not be none.
     void remove_piece(const Piece piece, const Square square);
 
     // Gets the type of piece on a certain square.
@@ -193,162 +128,163 @@ private:
     // color.
     bool is_occupied(const Square square, const Color color) const;
 
-    // Removes squares from an attack bitboard that are occupied by pieces
-    // belonging to the player who is to move this turn.
-    Bitboard discard_self_captures(const Bitboard attack_bitboard) const;
+    // Makes a move that is known to be legal and saves the ply data
+    // required to undo that move.
+    void make_legal_move(const Move move);
 
-    // Undoes the last move made.
-    void undo();
+    // Makes a move that is known to be legal for a player and saves the ply
+    // data required to undo that move.
+    template <Color color>
+    void make_legal_move(const Move move);
 
-    // Generates all pseudo-legal moves for the current player.
-    std::vector<Move> pseudo_legal_moves() const;
+    // Updates the position for a move that is known to be legal without
+    // saving the data required to undo it.
+    void play_move(const Move move);
 
-    // Generates all pseudo-legal moves for White.
-    std::vector<Move> pseudo_legal_w_moves() const;
+    // Updates the position for a move that is known to be legal for a player
+    // without saving the data required to undo it.
+    template <Color color>
+    void play_move(const Move move);
 
-    // Generates all pseudo-legal moves for Black.
-    std::vector<Move> pseudo_legal_b_moves() const;
+    // Undoes the last move made.
+    void undo();
 
-    // If the destination square is invalid or is occupied by a friendly
-    // piece, this returns Move::none. Otherwise, it returns a normal move
-    // with the origin and destination squares set. Used with
-    // find_dest_square() to generate simple moves.
-    Move pseudo_legal_normal_move(
-            const Square origin_sq,
-            const Square dest_sq
-    ) const;
+    // Undoes the last move made, which was made by the specified player.
+    template <Color color>
+    void undo();
 
-    // Generates a normal move from the origin square to wherever the
-    // directions lead to if that is a square within the boundaries of the
-    // board and is not occupied by any friendly pieces.
-    Move pseudo_legal_normal_move(
-            const Square origin_sq,
-            const std::vector<Direction> &directions
+    // Generates the legal moves of the specified kind for the current player
+    // and adds them to the move list.
+    void legal_moves(Move_list &moves, const Gen_type gen_type) const;
+
+    // Generates the legal moves of the specified kind for a player and adds
+    // them to the move list. The pieces giving check and the pinned pieces
+    // of the position are used so that only moves that do not leave the king
+    // in check are generated.
+    template <Color color>
+    void legal_moves(Move_list &moves, const Gen_type gen_type) const;
+
+    // Generates the castling moves for a player in which the king does not
+    // pass through or end up on an attacked square, and adds them to the move
+    // list. The king is assumed to not be in check.
+    template <Color color>
+    void legal_castling_moves(Move_list &moves, const Square king_sq) const;
+
+    // Generates the en passant moves for a player that do not leave their
+    // king in check, and adds them to the move list.
+    template <Color color>
+    void legal_en_passant_moves(Move_list &moves, const Square king_sq) const;
+
+    // Checks if a move is legal for a player without generating the other
+    // moves. The moving piece is checked against its attack table and the
+    // move is then checked against the pieces giving check and the pins.
+    template <Color color>
+    bool is_valid_move(const Move move) const;
+
+    // Checks if a player still has a castling right and nothing is in the
+    // way of the castling move. Whether the king passes through check is not
+    // checked.
+    bool castling_path_clear(const Castling_path &path) const;
+
+    // Generates the pseudo-legal moves for a bitboard of a player's pawns to
+    // squares on the target bitboard and adds them to the move list. The
+    // moves are generated for all the pawns at once by shifting the pawn
+    // bitboard. En passant moves are not included.
+    template <Color color>
+    void pseudo_legal_pawn_moves(
+            Move_list &moves,
+            const Bitboard pawns,
+            const Bitboard targets
     ) const;
 
-    // Generates the pawn north-by-1 move using the origin square. Returns
-    // Move::none if the move would not be pseudo-legal.
-    Move pawn_north_move(const Square origin_sq) const;
-
-    // Generates the pawn south-by-1 move using the origin square. Returns
-    // Move::none if the move would not be pseudo-legal.
-    Move pawn_south_move(const Square origin_sq) const;
-
-    // Generates the pawn north-by-2 move using the origin square. Returns
-    // Move::none if the move would not be pseudo-legal.
-    Move pawn_north_north_move(const Square origin_sq) const;
-
-    // Generates the pawn south-by-2 move using the origin square. Returns
-    // Move::none if the move would not be pseudo-legal.
-    Move pawn_south_south_move(const Square origin_sq) const;
-
-    // Generates the pawn north-east capture move using the origin square.
-    // Returns Move::none if the move would not be pseudo-legal.
-    Move pawn_north_east_move(const Square origin_sq) const;
-
-    // Generates the pawn south-east capture move using the origin square.
-    // Returns Move::none if the move would not be pseudo-legal.
-    Move pawn_south_east_move(const Square origin_sq) const;
-
-    // Generates the pawn north-west capture move using the origin square.
-    // Returns Move::none if the move would not be pseudo-legal.
-    Move pawn_north_west_move(const Square origin_sq) const;
-
-    // Generates the pawn south-west capture move using the origin square.
-    // Returns Move::none if the move would not be pseudo-legal.
-    Move pawn_south_west_move(const Square origin_sq) const;
-
-    // Generates the pawn north-east en passant move using the origin square.
-    // Returns Move::none if the move would not be pseudo-legal.
-    Move pawn_ep_north_east_move(const Square origin_sq) const;
-
-    // Generates the pawn south-east en passant move using the origin square.
-    // Returns Move::none if the move would not be pseudo-legal.
-    Move pawn_ep_south_east_move(const Square origin_sq) const;
-
-    // Generates the pawn north-west en passant move using the origin square.
-    // Returns Move::none if the move would not be pseudo-legal.
-    Move pawn_ep_north_west_move(const Square origin_sq) const;
-
-    // Generates the pawn south-west en passant move using the origin square.
-    // Returns Move::none if the move would not be pseudo-legal.
-    Move pawn_ep_south_west_move(const Square origin_sq) const;
-
-    // Generates the 4 north-by-1 promotion moves using the origin square.
-    // Returns Move::none if the moves would not be pseudo-legal.
-    std::array<Move, 4> pawn_promo_north_moves(const Square origin_sq) const;
-
-    // Generates the 4 south-by-1 promotion moves using the origin square.
-    // Returns Move::none if the moves would not be pseudo-legal.
-    std::array<Move, 4> pawn_promo_south_moves(const Square origin_sq) const;
-
-    // Generates the 4 north-east promotion capture moves using the origin
-    // square. Returns Move::none if the moves would not be pseudo-legal.
-    std::array<Move, 4> pawn_promo_north_east_moves(const Square origin_sq) const;
-
-    // Generates the 4 south-east promotion capture moves using the origin
-    // square. Returns Move::none if the moves would not be pseudo-legal.
-    std::array<Move, 4> pawn_promo_south_east_moves(const Square origin_sq) const;
-
-    // Generates the 4 north-west promotion capture moves using the origin
-    // square. Returns Move::none if the moves would not be pseudo-legal.
-    std::array<Move, 4> pawn_promo_north_west_moves(const Square origin_sq) const;
-
-    // Generates the 4 south-west promotion capture moves using the origin
-    // square. Returns Move::none if the moves would not be pseudo-legal.
-    std::array<Move, 4> pawn_promo_south_west_moves(const Square origin_sq) const;
-
-    // Generates the white kingside castling move as long as it has not been
-    // invalidated and no pieces are blocking it.
-    Move white_kingside_castle_move(const Square origin_sq) const;
-
-    // Generates the white queenside castling move as long as it has not been
-    // invalidated and no pieces are blocking it.
-    Move white_queenside_castle_move(const Square origin_sq) const;
-
-    // Generates the black kingside castling move as long as it has not been
-    // invalidated and no pieces are blocking it.
-    Move black_kingside_castle_move(const Square origin_sq) const;
-
-    // Generates the black queenside castling move as long as it has not been
-    // invalidated and no pieces are blocking it.
-    Move black_queenside_castle_move(const Square origin_sq) const;
-
-    // Generates all pseudo-legal moves for a white pawn that belongs to the
-    // player to move this turn.
-    std::vector<Move> pseudo_legal_w_pawn_moves(const Square square) const;
-
-    // Generates all pseudo-legal moves for a black pawn that belongs to the
-    // player to move this turn.
-    std::vector<Move> pseudo_legal_b_pawn_moves(const Square square) const;
-
-    // Generates all pseudo-legal knight moves for a knight that belongs to the
-    // player to move this turn.
-    std::vector<Move> pseudo_legal_knight_moves(const Square square) const;
-
-    // Generates all pseudo-legal bishop moves for a bishop that belongs to the
-    // player to move this turn.
-    std::vector<Move> pseudo_legal_bishop_moves(const Square square) const;
+    // Generates the en passant moves for a player and adds them to the move
+    // list.
+    template <Color color>
+    void pseudo_legal_en_passant_moves(Move_list &moves) const;
+
+    // Generates the pseudo-legal moves for a knight that belongs to the
+    // player to move this turn to squares on the target bitboard and adds
+    // them to the move list.
+    void pseudo_legal_knight_moves(
+            Move_list &moves,
+            const Square square,
+            const Bitboard targets
+    ) const;
 
-    // Generates all pseudo-legal rook moves for a rook that belongs to the
-    // player to move this turn. Castling does not count as a rook move.
-    std::vector<Move> pseudo_legal_rook_moves(const Square square) const;
+    // Generates the pseudo-legal moves for a bishop that belongs to the
+    // player to move this turn to squares on the target bitboard and adds
+    // them to the move list.
+    void pseudo_legal_bishop_moves(
+            Move_list &moves,
+            const Square square,
+            const Bitboard targets
+    ) const;
 
-    // Generates all pseudo-legal queen moves for a queen that belongs to the
-    // player to move this turn.
-    std::vector<Move> pseudo_legal_queen_moves(const Square square) const;
+    // Generates the pseudo-legal moves for a rook that belongs to the player
+    // to move this turn to squares on the target bitboard and adds them to
+    // the move list. Castling does not count as a rook move.
+    void pseudo_legal_rook_moves(
+            Move_list &moves,
+            const Square square,
+            const Bitboard targets
+    ) const;
 
-    // Generates all pseudo-legal king moves for the king that belongs to the
-    // player to move this turn.
-    std::vector<Move> pseudo_legal_king_moves(const Square square) const;
+    // Generates the pseudo-legal moves for a queen that belongs to the player
+    // to move this turn to squares on the target bitboard and adds them to
+    // the move list.
+    void pseudo_legal_queen_moves(
+            Move_list &moves,
+            const Square square,
+            const Bitboard targets
+    ) const;
 
     // The recursive function that returns the best evaluation found for a
     // ply. It utilizes minimax with alpha-beta pruning. This will not be
-    // used for the root ply.
-    int minimax(int depth, int alpha, int beta, bool is_maximizing);
-
-    // Uses piece-square tables to evaluate a square.
-    int eval_square(const Square square) const;
+    // used for the root ply. The moves are taken back as the mode specifies.
+    int minimax(
+            int depth,
+            int alpha,
+            int beta,
+            bool is_maximizing,
+            const Make_mode mode
+    );
+
+    // Makes a move, returns the evaluation that minimax() finds for the
+    // position after it and takes the move back as the mode specifies.
+    int search_move(
+            const Move move,
+            const int depth,
+            const int alpha,
+            const int beta,
+            const bool is_maximizing,
+            const Make_mode mode
+    );
+
+    // Returns the evaluation of a position with the specified game state. A
+    // game that is still in progress is evaluated using evaluate().
+    int eval_game_state(const Game_state state) const;
+
+    // Saves a quiet move that caused a beta cutoff as a killer move for the
+    // specified remaining depth.
+    void store_killer(const Move move, const int depth);
+
+    // Checks if a move is quiet, which means it is not a capture, en passant
+    // or promotion.
+    bool is_quiet(const Move move) const;
+
+    // Checks if the current position has occurred the specified number of
+    // times before since the last irreversible move.
+    bool is_repetition(unsigned times) const;
+
+    // Checks if the game has ended in a draw by repetition, the 50-move rule
+    // or insufficient material. The position must have occurred the
+    // specified number of times before to be a draw by repetition. Checkmate
+    // and stalemate are not checked.
+    Game_state draw_state(unsigned repetitions) const;
+
+    // Uses piece-square tables to evaluate a piece on a square. The piece
+    // must not be none.
+    int eval_piece(const Piece piece, const Square square) const;
 
     // Obtains the evaluation of the board in its current state.
     int evaluate() const;
@@ -357,29 +293,150 @@ private:
     // to be possible.
     bool insufficient_material() const;
 
-    // Checks if the specified square is under attack by a specified player.
-    bool square_attacked(const Square square, const Color attacker);
+    // Returns a bitboard of all the pieces of both colors that attack the
+    // specified square when the board has the specified occupancy.
+    Bitboard attackers_to(
+            const Square square,
+            const Bitboard occupancy
+    ) const;
+
+    // Returns a bitboard of all the squares attacked by a player when the
+    // board has the specified occupancy.
+    template <Color attacker>
+    Bitboard attacked_squares(const Bitboard occupancy) const;
+
+    // Returns the square a player's king is on.
+    template <Color color>
+    Square king_square() const;
+
+    // Returns a bitboard of the pieces belonging to a player that are pinned
+    // to their king.
+    template <Color color>
+    Bitboard pinned_pieces(const Square king_sq) const;
+
+    // Checks if the specified square is under attack by a player.
+    template <Color attacker>
+    bool square_attacked(const Square square) const;
 
     // Checks if the specified player's king is in check.
-    bool king_in_check(const Color color);
+    bool king_in_check(const Color color) const;
+
+    // Checks if the player to move is in check.
+    bool in_check() const;
+
+    // Computes the checkers and pinned pieces of the current position, in
+    // which the specified player is to move.
+    template <Color color>
+    void update_check_info();
+
+    // Computes the checkers and pinned pieces of the current position.
+    void update_check_info();
+
+    // Counts the leaf nodes of the tree of legal moves of the current
+    // position up to the specified depth, which must be at least 1. The moves
+    // of the last ply are counted without being made. If a table is passed,
+    // the counts of positions that were already visited at the same depth
+    // are looked up in it. The moves are taken back as the mode specifies.
+    unsigned long long perft_nodes(
+            const int depth,
+            Perft_table *table,
+            const Make_mode mode
+    );
+
+    // Counts the leaf nodes below each of the root moves up to the specified
+    // depth, which must be at least 1. The root moves are split among a pool
+    // of threads that each search their own copy of the game.
+    std::vector<unsigned long long> perft_root(
+            const Move_list &moves,
+            const int depth,
+            const unsigned threads,
+            Perft_table *table,
+            const Make_mode mode
+    ) const;
 public:
-    // Initializes Zobrist hashing and the evaluation variable.
+    // Initializes the Zobrist key, the evaluation variable and the check
+    // information.
     Game();
 
+    // Starts a game from a position in FEN. Throws std::invalid_argument if
+    // the FEN is invalid.
+    explicit Game(const std::string &fen);
+
+    // Returns a copy of the game, including its history.
+    Game clone() const;
+
+    // Puts the game back at the initial position. The memory used by the
+    // history is kept, so replaying a game does not need to allocate it
+    // again.
+    void reset();
+
     // Gets the color of the player who is to play this turn.
     const Color get_turn() const;
 
     // Makes a move and saves the ply data required to undo that move if it is
-    // legal. If the move is illegal, it undoes the move after making it and
-    // returns false. The move is assumed to be pseudo-legal.
+    // legal. If the move is illegal, it is not made and false is returned.
     bool make_move(const Move move);
 
-    // Checks if a move is pseudo-legal.
-    bool is_pseudo_legal(Move move) const;
+    // Passes the turn to the other player and saves the ply data required to
+    // undo it. If the player to move is in check, the turn is not passed and
+    // false is returned.
+    bool make_null_move();
+
+    // Undoes the last move made, which must be a null move.
+    void undo_null_move();
+
+    // Checks if a move is legal for the current player without generating
+    // the other moves.
+    bool is_valid_move(const Move move) const;
+
+    // Generates all legal moves for the current player. The pieces giving
+    // check and the pinned pieces of the position are used so that only
+    // moves that do not leave the king in check are generated.
+    Move_list legal_moves() const;
 
     // Search function used for the root ply. It uses minimax and alpha-beta
-    // pruning to return the best legal move for the current position.
-    Move best_move(const int depth);
+    // pruning to return the best legal move for the current position. The
+    // moves are taken back as the mode specifies.
+    Move best_move(
+            const int depth,
+            const Make_mode mode = Make_mode::make_undo
+    );
+
+    // Gets the number of positions visited by the last search.
+    unsigned long long get_nodes() const;
+
+    // Returns the bitboards of the pieces on the board, so that the attacks
+    // of many positions can be computed at once with batch_attacks().
+    Board_bitboards board_bitboards() const;
+
+    // Returns the squares attacked by each player and their mobility. This
+    // computes one position with the attack tables, like the move generator
+    // does.
+    Board_attacks board_attacks() const;
+
+    // Counts the leaf nodes of the tree of legal moves of the current
+    // position up to the specified depth. The root moves are split among the
+    // specified number of threads. If the hash table size in megabytes is not
+    // 0, the counts of positions that were already visited are looked up in a
+    // table of that size, which is shared by the threads. The moves are taken
+    // back as the mode specifies.
+    unsigned long long perft(
+            const int depth,
+            const unsigned threads = 1,
+            const unsigned hash_mb = 0,
+            const Make_mode mode = Make_mode::make_undo
+    ) const;
+
+    // Returns the number of leaf nodes below each legal move of the current
+    // position up to the specified depth, one move per line, followed by the
+    // total. The threads and hash table size are used like they are in
+    // perft().
+    // Example line: "e2e4: 20"
+    std::string divide(
+            const int depth,
+            const unsigned threads = 1,
+            const unsigned hash_mb = 0
+    ) const;
 
     // Generates and returns a move using a string. The first two characters
     // indicate the starting position, the two characters after that indicate
@@ -391,15 +448,24 @@ public:
     // Converts a move to its string representation.
     std::string move_to_string(const Move move) const;
 
-    // Returns the FEN representation of the board.
+    // Sets up the position from a FEN string and clears the history. All six
+    // fields are read, but the halfmove clock and fullmove number may be
+    // left out. Returns false and leaves the game unchanged if the FEN is
+    // invalid.
+    bool set_fen(const std::string &fen);
+
+    // Returns the FEN representation of the position, with all six fields.
     std::string fen() const;
 
+    // Returns the Zobrist key of the current position.
+    Bitstring hash() const;
+
     // Checks if the game has ended, and if so, why.
     Game_state game_state();
 
-    // Using a list of possible moves, checks if the game has ended, and if
-    // so, why.
-    Game_state game_state(const std::vector<Move> &possible_moves);
+    // Using the list of legal moves for the current position, checks if the
+    // game has ended, and if so, why.
+    Game_state game_state(const Move_list &possible_moves);
 };
 
 #endif  //DISCORD_CHESS_BOT_GAME_H
@@ -0,0 +1,46 @@
+#include <memory>
+#include <vector>
+#include "game.h"
+#include "game_pool.h"
+
+
+// Returns a game at the initial position. A released game is reused if there
+// is one.
+Game *Game_pool::acquire()
+{
+    if (free_games.empty())
+    {
+        games.push_back(std::make_unique<Game>());
+        return games.back().get();
+    }
+
+    Game *game = free_games.back();
+    free_games.pop_back();
+
+    return game;
+}
+
+
+// Gives a finished game back to the pool. The game must have come from this
+// pool and must not be used after it is released.
+void Game_pool::release(Game *game)
+{
+    // Resetting the game now keeps acquire() cheap when a burst of games is
+    // started.
+    game->reset();
+    free_games.push_back(game);
+}
+
+
+// Returns the number of games created by the pool.
+unsigned Game_pool::size() const
+{
+    return games.size();
+}
+
+
+// Returns the number of released games waiting to be reused.
+unsigned Game_pool::available() const
+{
+    return free_games.size();
+}
@@ -0,0 +1,36 @@
+#ifndef DISCORD_CHESS_BOT_GAME_POOL_H
+#define DISCORD_CHESS_BOT_GAME_POOL_H
+
+#include <memory>
+#include <vector>
+#include "game.h"
+
+
+// Recycles finished games, so that starting a game reuses the memory of an
+// earlier one instead of allocating a new game and history. The pool owns
+// every game it hands out, and they stay valid until the pool is destroyed.
+class Game_pool
+{
+private:
+    // Every game created by the pool.
+    std::vector<std::unique_ptr<Game>> games;
+
+    // The games that have been released and can be handed out again.
+    std::vector<Game *> free_games;
+public:
+    // Returns a game at the initial position. A released game is reused if
+    // there is one.
+    Game *acquire();
+
+    // Gives a finished game back to the pool. The game must have come from
+    // this pool and must not be used after it is released.
+    void release(Game *game);
+
+    // Returns the number of games created by the pool.
+    unsigned size() const;
+
+    // Returns the number of released games waiting to be reused.
+    unsigned available() const;
+};
+
+#endif  //DISCORD_CHESS_BOT_GAME_POOL_H
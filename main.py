@@ -13,6 +13,10 @@ description = "A bot that can manage chess games and play in them."
 
 guilds = {}
 
+# Finished games are recycled by the pool, so a burst of starts does not
+# allocate a new game for each one.
+game_pool = chessbot.Game_pool()
+
 
 def prefix(bot, message):
     """Returns the prefix of the guild a message was sent in."""
@@ -51,13 +55,17 @@ class Game():
     player to move this turn
 
     get_board_url() - returns a URL of an image showing the chessboard
+
+    release() - gives the instance of the game back to the pool once the game
+    is over
     """
     def __init__(self, player_id_1, player_id_2):
         """Initializes a game between two players. White and Black are chosen
         randomly.
         """
-        # Initialize an instance of the class from the chess library.
-        self.game = chessbot.Game()
+        # Get an instance of the class from the chess library. The pool owns
+        # it and resets it when it is released.
+        self.game = game_pool.acquire()
 
         # Randomly choose who is White and who is Black.
         if random.randint(0, 1) == 1:
@@ -77,11 +85,19 @@ class Game():
         return self.game.move_to_string(move)
 
 
+    def release(self):
+        """Gives the instance of the game back to the pool. The game must not
+        be used afterwards.
+        """
+        game_pool.release(self.game)
+        self.game = None
+
+
     def get_board_url(self):
         """Gets the URL to an image of the board in its current state."""
         template = "http://www.fen-to-image.com/image/36/double/coords/{}"
-        # Append the FEN of the board to the URL.
-        return template.format(self.game.fen())
+        # Append the piece placement field of the FEN to the URL.
+        return template.format(self.game.fen().split()[0])
 
 
     def get_turn(self):
@@ -156,11 +172,10 @@ class Game():
         move = self.game.string_to_move(move_str)
 
         invalid_move_str = move == chessbot.Move_none
-        pseudo_illegal_move = not self.game.is_pseudo_legal(move)
 
-        # Throw an exception if this move is invalid.
-        if (invalid_move_str or pseudo_illegal_move or
-                not self.game.make_move(move)):
+        # Throw an exception if this move is invalid. The move is not made if
+        # it is illegal.
+        if invalid_move_str or not self.game.make_move(move):
             raise InvalidMove()
 
 
@@ -206,6 +221,16 @@ def find_game_key(guild_id, user_id):
     return None
 
 
+def delete_game(guild_id, game_key):
+    """Deletes a game that has ended and gives its instance back to the pool.
+
+    guild_id - the ID of the guild the game is in
+    game_key - the key of the game
+    """
+    guilds[guild_id].games[game_key].release()
+    del guilds[guild_id].games[game_key]
+
+
 def is_to_play(game, user_id):
     """Checks if the specified user is to play this turn in the specified
     game.
@@ -350,7 +375,7 @@ async def resign(ctx):
                   guilds[guild_id].games[game_key].get_board_url())
 
     # Delete the game instance.
-    del guilds[guild_id].games[game_key]
+    delete_game(guild_id, game_key)
 
 
 @bot.command(pass_context=True)
@@ -419,7 +444,7 @@ async def move(ctx, move_str: str):
     # if that is the case.
     if guilds[guild_id].games[game_key].ended():
         await ctx.send(guilds[guild_id].games[game_key].end_game_message())
-        del guilds[guild_id].games[game_key]
+        delete_game(guild_id, game_key)
         return
 
     # If the game has not ended and it is the bot's turn to play, make a move.
@@ -434,15 +459,12 @@ async def move(ctx, move_str: str):
         if guilds[guild_id].games[game_key].ended():
             await ctx.send(guilds[guild_id].games[game_key] \
                                             .end_game_message())
-            del guilds[guild_id].games[game_key]
+            delete_game(guild_id, game_key)
 
 
 
 def main():
     """Initializes the bot and its data-saving mechanism."""
-    # Initialize the magic moves library.
-    chessbot.initmagicmoves()
-
     # Run the bot.
     bot.run(config.token)
 
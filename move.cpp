@@ -1,9 +1,25 @@
-#include <algorithm>
+#include <array>
 #include "utils.h"
 #include "types.h"
 #include "game.h"
 
 
+// The castling rights that are kept when a piece moves from or to each
+// square. Moving the king or a rook and capturing a rook lose the castling
+// rights that need that piece. Square A1 comes first.
+const std::array<unsigned, 64> castling_rights_masks =
+{
+    13, 15, 15, 15, 12, 15, 15, 14,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+     7, 15, 15, 15,  3, 15, 15, 11
+};
+
+
 // Checks the origin and destination squares of a move and updates
 // the castling rights accordingly.
 void Game::update_castling_rights(
@@ -11,65 +27,60 @@ void Game::update_castling_rights(
         const Square dest_sq
 )
 {
-    // Invalidate a specific type of castling if a rook moves or is captured.
-    // White kingside castling
-    if (origin_sq == Square::H1 || dest_sq == Square::H1)
-    {
-        invalidate_w_kingside_castling();
-    }
-    // White queenside castling
-    if (origin_sq == Square::A1 || dest_sq == Square::A1)
-    {
-        invalidate_w_queenside_castling();
-    }
-    // Black kingside castling
-    if (origin_sq == Square::H8 || dest_sq == Square::H8)
-    {
-        invalidate_b_kingside_castling();
-    }
-    // Black queenside castling
-    if (origin_sq == Square::A8 || dest_sq == Square::A8)
-    {
-        invalidate_b_queenside_castling();
-    }
+    position.key ^= hash_castling(position.castling_rights);
+    position.castling_rights = static_cast<Castling_right>(
+            static_cast<unsigned>(position.castling_rights) &
+            castling_rights_masks[static_cast<unsigned>(origin_sq)] &
+            castling_rights_masks[static_cast<unsigned>(dest_sq)]
+    );
+    position.key ^= hash_castling(position.castling_rights);
+}
 
-    // Invalidate castling for a player if their king moves.
-    // White
-    if (origin_sq == Square::E1)
-    {
-        invalidate_white_castling();
-    }
-    // Black
-    else if (origin_sq == Square::E8)
+
+// Makes a move and saves the ply data required to undo that move if it is
+// legal. If the move is illegal, it is not made and false is returned.
+bool Game::make_move(const Move move)
+{
+    if (!is_valid_move(move))
     {
-        invalidate_black_castling();
+        return false;
     }
+
+    make_legal_move(move);
+    return true;
 }
 
 
-// Checks if a move is pseudo-legal.
-bool Game::is_pseudo_legal(Move move) const
+// Makes a move that is known to be legal for a player and saves the ply data
+// required to undo that move.
+template <Color color>
+void Game::make_legal_move(const Move move)
 {
-    std::vector<Move> moves = pseudo_legal_moves();
+    // Data needs to be saved to undo moves later.
+    Ply_data ply_data;
+    ply_data.key = hash();
+    ply_data.last_move = move;
+    ply_data.captured_piece = piece_on(extract_dest_sq(move));
+    ply_data.castling_rights = position.castling_rights;
+    ply_data.en_passant_square = position.en_passant_square;
+    ply_data.rule50 = position.rule50;
+    ply_data.plies_from_null = plies_from_null;
+    ply_data.check_info = check_info;
 
-    // Check if the move was found in the list of generated pseudo-legal
-    // moves.
-    if (std::find(moves.begin(), moves.end(), move) != moves.end())
-    {
-        return true;
-    }
-    else
-    {
-        return false;
-    }
+    play_move<color>(move);
+
+    history.push_back(ply_data);
+    plies_from_null++;
 }
 
 
-// Makes a move and saves the ply data required to undo that move if it is
-// legal. If the move is illegal, it undoes the move after making it and
-// returns false. The move is assumed to be pseudo-legal.
-bool Game::make_move(const Move move)
+// Updates the position for a move that is known to be legal for a player
+// without saving the data required to undo it.
+template <Color color>
+void Game::play_move(const Move move)
 {
+    constexpr Piece own_pawn = make_piece(color, Piece_type::pawn);
+
     // Extract data from the move.
     const auto origin_sq = extract_origin_sq(move);
     const auto dest_sq = extract_dest_sq(move);
@@ -79,23 +90,13 @@ bool Game::make_move(const Move move)
     const auto moved_piece = piece_on(origin_sq);
     const auto captured_piece = piece_on(dest_sq);
 
-    bool is_illegal_move = false;
-
-    // Data needs to be saved to undo moves later.
-    Ply_data ply_data;
-    ply_data.last_move = move;
-    ply_data.captured_piece = captured_piece;
-    ply_data.castling_rights = castling_rights;
-    ply_data.en_passant_square = en_passant_square;
-    ply_data.rule50 = rule50;
-    ply_data.threefold_repetition = false;
-
     // Update the castling rights.
     update_castling_rights(origin_sq, dest_sq);
 
     // Update the 50-move and en passant variables.
-    rule50++;
-    en_passant_square = Square::none;
+    position.rule50++;
+    position.key ^= hash_en_passant(position.en_passant_square);
+    position.en_passant_square = Square::none;
 
     switch (move_type)
     {
@@ -104,29 +105,37 @@ bool Game::make_move(const Move move)
         // removing any pieces that exist on that square.
         case Move_type::normal:
             remove_piece(moved_piece, origin_sq);
-            remove_piece(captured_piece, dest_sq);
+
+            if (captured_piece != Piece::none)
+            {
+                remove_piece(captured_piece, dest_sq);
+            }
+
             add_piece(moved_piece, dest_sq);
 
             // If this is a two-square pawn move, set the en passant
             // square.
-            if ((moved_piece == Piece::w_pawn) &&
-                (dest_sq == north_of(north_of(origin_sq))))
+            if (moved_piece == own_pawn)
             {
-                en_passant_square = north_of(origin_sq);
-            }
-            // Two-square black pawn move.
-            else if ((moved_piece == Piece::b_pawn) &&
-                     (dest_sq == south_of(south_of(origin_sq))))
-            {
-                en_passant_square = south_of(origin_sq);
+                const Square push_sq = color == Color::white ?
+                                       north_of(origin_sq) :
+                                       south_of(origin_sq);
+                const Square double_push_sq = color == Color::white ?
+                                              north_of(push_sq) :
+                                              south_of(push_sq);
+
+                if (dest_sq == double_push_sq)
+                {
+                    position.en_passant_square = push_sq;
+                    position.key ^= hash_en_passant(push_sq);
+                }
             }
 
             // If a piece was captured or a pawn was moved, reset the 50-move
             // rule variable.
-            if (captured_piece != Piece::none ||
-               (moved_piece == Piece::w_pawn || moved_piece == Piece::b_pawn))
+            if (captured_piece != Piece::none || moved_piece == own_pawn)
             {
-                rule50 = 0;
+                position.rule50 = 0;
             }
             break;
         // Make a castling move by moving the rook and king to the appropriate
@@ -151,24 +160,21 @@ bool Game::make_move(const Move move)
             add_piece(moved_piece, dest_sq);
             remove_piece(rook_type, rook_origin_sq);
             add_piece(rook_type, rook_dest_sq);
-
-            // If the origin square or the square the king moves through is
-            // under attack, this move is illegal.
-            if (square_attacked(origin_sq, reverse_color(turn)) ||
-                square_attacked(rook_dest_sq, reverse_color((turn))))
-            {
-                is_illegal_move = true;
-            }
             break;
 
         // Make a promotion move.
         case Move_type::promotion:
             remove_piece(moved_piece, origin_sq);
-            remove_piece(captured_piece, dest_sq);
-            add_piece(promo_piece_to_piece(promo_piece, turn), dest_sq);
+
+            if (captured_piece != Piece::none)
+            {
+                remove_piece(captured_piece, dest_sq);
+            }
+
+            add_piece(promo_piece_to_piece(promo_piece, color), dest_sq);
 
             // A pawn was moved, so the 50-move rule variable should be reset.
-            rule50 = 0;
+            position.rule50 = 0;
             break;
 
         // Make an en passant move.
@@ -184,73 +190,85 @@ bool Game::make_move(const Move move)
                     enemy_pawn,
                     enemy_pawn_sq,
                     dest_sq,
-                    turn
+                    color
             );
 
             remove_piece(enemy_pawn, enemy_pawn_sq);
 
             // A pawn was moved, so the 50-move rule variable should be reset.
-            rule50 = 0;
+            position.rule50 = 0;
             break;
     }
 
-    // Keep track of this hash's occurrence to be able to detect threefold
-    // repetition.
-    const auto current_game_hash = hash();
+    end_turn();
+    update_check_info<reverse_color(color)>();
+}
 
-    if (hash_count.find(current_game_hash) == hash_count.end())
-    {
-        hash_count[current_game_hash] = 1;
-    }
-    else
+
+// Passes the turn to the other player and saves the ply data required to
+// undo it. If the player to move is in check, the turn is not passed and false
+// is returned.
+bool Game::make_null_move()
+{
+    if (in_check())
     {
-        hash_count[current_game_hash]++;
-        // Check if threefold repetition has occurred.
-        if (hash_count[current_game_hash] >= 3)
-        {
-            ply_data.threefold_repetition = true;
-        }
+        return false;
     }
 
+    Ply_data ply_data;
+    ply_data.key = hash();
+    ply_data.last_move = Move::none;
+    ply_data.captured_piece = Piece::none;
+    ply_data.castling_rights = position.castling_rights;
+    ply_data.en_passant_square = position.en_passant_square;
+    ply_data.rule50 = position.rule50;
+    ply_data.plies_from_null = plies_from_null;
+    ply_data.check_info = check_info;
     history.push_back(ply_data);
-    end_turn();
 
-    // If the player who made the move is now in check, this is an illegal
-    // move.
-    if (king_in_check(reverse_color(turn)))
-    {
-        is_illegal_move = true;
-    }
+    // En passant is only possible right after the double pawn push.
+    position.key ^= hash_en_passant(position.en_passant_square);
+    position.en_passant_square = Square::none;
 
-    // If this is an illegal move, undo it and return false to indicate that
-    // it is one.
-    if (is_illegal_move)
-    {
-        undo();
-        return false;
-    }
+    // A position from before a null move can not really be repeated, so the
+    // scan for repetitions ends here. The 50-move rule variable is left as it
+    // is.
+    plies_from_null = 0;
+
+    end_turn();
+    update_check_info();
 
     return true;
 }
 
 
-// Undoes the last move made.
-void Game::undo()
+// Undoes the last move made, which must be a null move.
+void Game::undo_null_move()
 {
-    end_turn();
+    const Ply_data last_ply = history.back();
+    history.pop_back();
+
+    position.turn = reverse_color(position.turn);
+    position.key = last_ply.key;
+    position.en_passant_square = last_ply.en_passant_square;
+    plies_from_null = last_ply.plies_from_null;
+    check_info = last_ply.check_info;
+}
 
 
-    // Treat this position as if it never happened for the purposes of
-    // threefold repetition.
-    hash_count[hash()]--;
+// Undoes the last move made, which was made by the specified player.
+template <Color color>
+void Game::undo()
+{
+    end_turn();
 
     // Restore and delete the saved ply data.
     const Ply_data last_ply = history.back();
     history.pop_back();
 
-    castling_rights = last_ply.castling_rights;
-    en_passant_square = last_ply.en_passant_square;
-    rule50 = last_ply.rule50;
+    position.castling_rights = last_ply.castling_rights;
+    position.en_passant_square = last_ply.en_passant_square;
+    position.rule50 = last_ply.rule50;
     Piece captured_piece = last_ply.captured_piece;
 
     const Move move = last_ply.last_move;
@@ -267,7 +285,11 @@ void Game::undo()
         case Move_type::normal:
             remove_piece(moved_piece, dest_sq);
             add_piece(moved_piece, origin_sq);
-            add_piece(captured_piece, dest_sq);
+
+            if (captured_piece != Piece::none)
+            {
+                add_piece(captured_piece, dest_sq);
+            }
             break;
         // Undo a castling move by moving the rook and king to their original
         // positions.
@@ -296,20 +318,13 @@ void Game::undo()
         // restored.
         case Move_type::promotion:
             remove_piece(moved_piece, dest_sq);
-            add_piece(captured_piece, dest_sq);
-            Piece pawn_type;
-            // White
-            if (turn == Color::white)
-            {
-                pawn_type = Piece::w_pawn;
-            }
-            // Black
-            else
+
+            if (captured_piece != Piece::none)
             {
-                pawn_type = Piece::b_pawn;
+                add_piece(captured_piece, dest_sq);
             }
 
-            add_piece(pawn_type, origin_sq);
+            add_piece(make_piece(color, Piece_type::pawn), origin_sq);
             break;
         // Undo an en passant move by moving back the moved pawn and restoring
         // the captured pawn.
@@ -324,10 +339,61 @@ void Game::undo()
                     enemy_pawn,
                     enemy_pawn_sq,
                     dest_sq,
-                    turn
+                    color
             );
 
             add_piece(enemy_pawn, enemy_pawn_sq);
             break;
     }
+
+    // The key and check information saved before the move are restored
+    // directly instead of being computed again.
+    position.key = last_ply.key;
+    plies_from_null = last_ply.plies_from_null;
+    check_info = last_ply.check_info;
+}
+
+
+// Makes a move that is known to be legal and saves the ply data required to
+// undo that move.
+void Game::make_legal_move(const Move move)
+{
+    if (position.turn == Color::white)
+    {
+        make_legal_move<Color::white>(move);
+    }
+    else
+    {
+        make_legal_move<Color::black>(move);
+    }
+}
+
+
+// Updates the position for a move that is known to be legal without saving
+// the data required to undo it.
+void Game::play_move(const Move move)
+{
+    if (position.turn == Color::white)
+    {
+        play_move<Color::white>(move);
+    }
+    else
+    {
+        play_move<Color::black>(move);
+    }
+}
+
+
+// Undoes the last move made.
+void Game::undo()
+{
+    // The last move was made by the player who is not to move this turn.
+    if (position.turn == Color::black)
+    {
+        undo<Color::white>();
+    }
+    else
+    {
+        undo<Color::black>();
+    }
 }
@@ -138,7 +138,7 @@ Move Game::string_to_move(const std::string move_str) const
     else if (piece_moved == Piece::w_pawn || piece_moved == Piece::b_pawn)
     {
         // To en passant square - en passant.
-        if (dest_sq == en_passant_square)
+        if (dest_sq == position.en_passant_square)
         {
             move_type = Move_type::en_passant;
         }
@@ -1,962 +1,644 @@
-#include <vector>
-#include <array>
 #include <algorithm>
+#include <array>
 #include "game.h"
 #include "utils.h"
-#include "lib/magicmoves.h"
-
-
-// Generates all pseudo-legal moves for White.
-std::vector<Move> Game::pseudo_legal_w_moves() const
+#include "attacks.h"
+
+
+// What a castling move needs besides its castling right: the squares between
+// the king and the rook have to be empty, and the squares the king passes
+// through or ends up on cannot be attacked.
+struct Castling_path
+{
+    Castling_right right;
+    Square king_origin_sq;
+    Square king_dest_sq;
+    Bitboard empty_squares;
+    Bitboard safe_squares;
+};
+
+// The castling paths of white followed by those of black, kingside first.
+const std::array<Castling_path, 4> castling_paths =
+{{
+    {Castling_right::w_kingside, Square::E1, Square::G1,
+     0x0000000000000060, 0x0000000000000060},
+    {Castling_right::w_queenside, Square::E1, Square::C1,
+     0x000000000000000E, 0x000000000000000C},
+    {Castling_right::b_kingside, Square::E8, Square::G8,
+     0x6000000000000000, 0x6000000000000000},
+    {Castling_right::b_queenside, Square::E8, Square::C8,
+     0x0E00000000000000, 0x0C00000000000000}
+}};
+
+
+// Checks if a player still has a castling right and nothing is in the way of
+// the castling move. Whether the king passes through check is not checked.
+bool Game::castling_path_clear(const Castling_path &path) const
+{
+    return (static_cast<unsigned>(position.castling_rights) &
+            static_cast<unsigned>(path.right)) != 0 &&
+           (all_pieces() & path.empty_squares) == 0;
+}
+
+
+// Generates the pseudo-legal moves for a bitboard of a player's pawns to
+// squares on the target bitboard and adds them to the move list. The moves
+// are generated for all the pawns at once by shifting the pawn bitboard. En
+// passant moves are not included.
+template <Color color>
+void Game::pseudo_legal_pawn_moves(
+        Move_list &moves,
+        const Bitboard pawns,
+        const Bitboard targets
+) const
 {
-    std::vector<Move> all_moves;
+    const Bitboard enemy_bitboard = pieces_of(reverse_color(color));
+    const Bitboard empty_bitboard = ~all_pieces();
 
-    // Generate the pseudo-legal moves for each square.
-    for (auto square_index = 0; square_index < 64; square_index++)
-    {
-        std::vector<Move> piece_moves;
-        const auto square = static_cast<Square>(square_index);
+    // The rows and offsets depend on the direction the pawns move in.
+    const Bitboard double_push_row = color == Color::white ? row_3 : row_6;
+    const Bitboard promo_row = color == Color::white ? row_8 : row_1;
+    const int push_offset = color == Color::white ? 8 : -8;
+    const int east_offset = color == Color::white ? 9 : -7;
+    const int west_offset = color == Color::white ? 7 : -9;
 
-        switch (piece_on(square))
-        {
-            case Piece::w_pawn:
-                piece_moves = pseudo_legal_w_pawn_moves(square);
-                break;
-            case Piece::w_knight:
-                piece_moves = pseudo_legal_knight_moves(square);
-                break;
-            case Piece::w_bishop:
-                piece_moves = pseudo_legal_bishop_moves(square);
-                break;
-            case Piece::w_rook:
-                piece_moves = pseudo_legal_rook_moves(square);
-                break;
-            case Piece::w_queen:
-                piece_moves = pseudo_legal_queen_moves(square);
-                break;
-            case Piece::w_king:
-                piece_moves = pseudo_legal_king_moves(square);
-                break;
-            default:
-                continue;
-        }
+    // Squares the pawns can move to by moving forward by 1 square.
+    const Bitboard single_pushes = shift_forward<color>(pawns) &
+                                   empty_bitboard;
 
-        all_moves.insert(
-                all_moves.end(),
-                piece_moves.begin(),
-                piece_moves.end());
-    }
+    // Pawns on their 2nd row that moved to their 3rd row above can move
+    // forward by another square.
+    const Bitboard double_pushes = shift_forward<color>(
+            single_pushes & double_push_row
+    ) & empty_bitboard & targets;
 
-    return all_moves;
-}
+    // Squares with enemy pieces the pawns can capture.
+    const Bitboard east_captures = shift_forward_east<color>(pawns) &
+                                   enemy_bitboard & targets;
+    const Bitboard west_captures = shift_forward_west<color>(pawns) &
+                                   enemy_bitboard & targets;
 
+    // Generate non-capture moves.
+    gen_pawn_moves_from_bitboard(
+            moves,
+            single_pushes & targets & ~promo_row,
+            push_offset,
+            Move_type::normal
+    );
+    gen_pawn_moves_from_bitboard(
+            moves,
+            double_pushes,
+            2 * push_offset,
+            Move_type::normal
+    );
 
-// Generates all pseudo-legal moves for Black.
-std::vector<Move> Game::pseudo_legal_b_moves() const
-{
-    std::vector<Move> all_moves;
-
-    // Generate the pseudo-legal moves for each square.
-    for (auto square_index = 0; square_index < 64; square_index++)
-    {
-        std::vector<Move> piece_moves;
-        const auto square = static_cast<Square>(square_index);
-
-        switch (piece_on(square))
-        {
-            case Piece::b_pawn:
-                piece_moves = pseudo_legal_b_pawn_moves(square);
-                break;
-            case Piece::b_knight:
-                piece_moves = pseudo_legal_knight_moves(square);
-                break;
-            case Piece::b_bishop:
-                piece_moves = pseudo_legal_bishop_moves(square);
-                break;
-            case Piece::b_rook:
-                piece_moves = pseudo_legal_rook_moves(square);
-                break;
-            case Piece::b_queen:
-                piece_moves = pseudo_legal_queen_moves(square);
-                break;
-            case Piece::b_king:
-                piece_moves = pseudo_legal_king_moves(square);
-                break;
-            default:
-                continue;
-        }
-
-        all_moves.insert(
-                all_moves.end(),
-                piece_moves.begin(),
-                piece_moves.end());
-    }
+    // Generate capture moves.
+    gen_pawn_moves_from_bitboard(
+            moves,
+            east_captures & ~promo_row,
+            east_offset,
+            Move_type::normal
+    );
+    gen_pawn_moves_from_bitboard(
+            moves,
+            west_captures & ~promo_row,
+            west_offset,
+            Move_type::normal
+    );
 
-    return all_moves;
+    // Generate non-capture and capture promotion moves.
+    gen_promo_moves_from_bitboard(
+            moves,
+            single_pushes & targets & promo_row,
+            push_offset
+    );
+    gen_promo_moves_from_bitboard(
+            moves,
+            east_captures & promo_row,
+            east_offset
+    );
+    gen_promo_moves_from_bitboard(
+            moves,
+            west_captures & promo_row,
+            west_offset
+    );
 }
 
 
-// Generates all pseudo-legal moves for the current player.
-std::vector<Move> Game::pseudo_legal_moves() const
+// Generates the en passant moves for a player and adds them to the move list.
+template <Color color>
+void Game::pseudo_legal_en_passant_moves(Move_list &moves) const
 {
-    if (turn == Color::white)
-    {
-        return pseudo_legal_w_moves();
-    }
-    else
+    if (position.en_passant_square == Square::none)
     {
-        return pseudo_legal_b_moves();
+        return;
     }
-}
 
+    const Bitboard en_passant_bitboard = square_to_bb(
+            position.en_passant_square
+    );
+    const Bitboard own_pawns = pieces_of(color, Piece_type::pawn);
 
-// If the destination square is invalid or is occupied by a friendly
-// piece, this returns Move::none. Otherwise, it returns a normal move
-// with the origin and destination squares set. Used with
-// find_dest_square() to generate simple moves.
-Move Game::pseudo_legal_normal_move(
-        const Square origin_sq,
-        const Square dest_sq
-) const
-{
-    // Return Move::none if the destination square is invalid or is occupied
-    // by a friendly piece.
-    if (dest_sq != Square::none && !is_occupied(dest_sq, turn))
-    {
-        return create_normal_move(origin_sq, dest_sq);
-    }
-    else
-    {
-        return Move::none;
-    }
+    gen_pawn_moves_from_bitboard(
+            moves,
+            shift_forward_east<color>(own_pawns) & en_passant_bitboard,
+            color == Color::white ? 9 : -7,
+            Move_type::en_passant
+    );
+    gen_pawn_moves_from_bitboard(
+            moves,
+            shift_forward_west<color>(own_pawns) & en_passant_bitboard,
+            color == Color::white ? 7 : -9,
+            Move_type::en_passant
+    );
 }
 
 
-// Generates a normal move from the origin square to wherever the
-// directions lead to if that is a square within the boundaries of the
-// board and is not occupied by any friendly pieces.
-Move Game::pseudo_legal_normal_move(
-        const Square origin_sq,
-        const std::vector<Direction> &directions
+// Generates the pseudo-legal moves for a knight that belongs to the player
+// to move this turn to squares on the target bitboard and adds them to the
+// move list.
+void Game::pseudo_legal_knight_moves(
+        Move_list &moves,
+        const Square square,
+        const Bitboard targets
 ) const
 {
-    const auto dest_sq = find_dest_square(
-            origin_sq,
-            directions
-    );
-
-    // Generate a move to the specified square as long as it is within the
-    // boundaries of the board and is not occupied by any friendly pieces.
-    return pseudo_legal_normal_move(origin_sq, dest_sq);
-}
+    // Look up the attack bitboard in the precomputed table.
+    Bitboard attack_bitboard = knight_attacks[static_cast<unsigned>(square)];
 
+    // Only keep the target squares.
+    attack_bitboard &= targets;
 
-// Removes squares from an attack bitboard that are occupied by pieces
-// belonging to the player who is to move this turn.
-Bitboard Game::discard_self_captures(const Bitboard attack_bitboard) const
-{
-    // Discard self-captures.
-    if (turn == Color::white)
-    {
-        return attack_bitboard & ~white_bitboard;
-    }
-    else
-    {
-        return attack_bitboard & ~black_bitboard;
-    }
+    gen_moves_from_bitboard(moves, square, attack_bitboard);
 }
 
 
-// Generates the pawn north-by-1 move using the origin square. Returns
-// Move::none if the move would not be pseudo-legal.
-Move Game::pawn_north_move(const Square origin_sq) const
+// Generates the pseudo-legal moves for a bishop that belongs to the player
+// to move this turn to squares on the target bitboard and adds them to the
+// move list.
+void Game::pseudo_legal_bishop_moves(
+        Move_list &moves,
+        const Square square,
+        const Bitboard targets
+) const
 {
-    const auto dest_sq = find_dest_square(origin_sq, {Direction::north});
+    // Look up the attack bitboard in the slider attack tables.
+    Bitboard attack_bitboard = bishop_attacks(square, all_pieces());
 
-    // Generate the non-attack move of moving north by 1 square as long as
-    // that square is in the boundaries of the board and is not occupied.
-    if (dest_sq != Square::none && !is_occupied(dest_sq))
-    {
-        return create_normal_move(origin_sq, dest_sq);
-    }
-    else
-    {
-        return Move::none;
-    }
-}
+    // Only keep the target squares.
+    attack_bitboard &= targets;
 
-
-// Generates the pawn south-by-1 move using the origin square. Returns
-// Move::none if the move would not be pseudo-legal.
-Move Game::pawn_south_move(const Square origin_sq) const
-{
-    const auto dest_sq = find_dest_square(origin_sq, {Direction::south});
-
-    // Generate the non-attack move of moving south by 1 square as long as
-    // that square is in the boundaries of the board and is not occupied.
-    if (dest_sq != Square::none && !is_occupied(dest_sq))
-    {
-        return create_normal_move(origin_sq, dest_sq);
-    }
-    else
-    {
-        return Move::none;
-    }
+    gen_moves_from_bitboard(moves, square, attack_bitboard);
 }
 
 
-// Generates the pawn north-by-2 move using the origin square. Returns
-// Move::none if the move would not be pseudo-legal.
-Move Game::pawn_north_north_move(const Square origin_sq) const
+// Generates the pseudo-legal moves for a rook that belongs to the player to
+// move this turn to squares on the target bitboard and adds them to the move
+// list. Castling does not count as a rook move.
+void Game::pseudo_legal_rook_moves(
+        Move_list &moves,
+        const Square square,
+        const Bitboard targets
+) const
 {
-    const auto dest_sq = north_of(north_of(origin_sq));
+    // Look up the attack bitboard in the slider attack tables.
+    Bitboard attack_bitboard = rook_attacks(square, all_pieces());
 
-    // If the pawn is on the 2nd row (meaning it has not moved yet), generate
-    // the 2-squares-north move as long as both squares north of the pawn are
-    // not occupied.
-    if (on_bitboard(origin_sq, row_2) && !is_occupied(north_of(origin_sq)) &&
-        !is_occupied(dest_sq))
-    {
-        return create_normal_move(origin_sq, dest_sq);
-    }
-    else
-    {
-        return Move::none;
-    }
+    // Only keep the target squares.
+    attack_bitboard &= targets;
+
+    gen_moves_from_bitboard(moves, square, attack_bitboard);
 }
 
 
-// Generates the pawn south-by-2 move using the origin square. Returns
-// Move::none if the move would not be pseudo-legal.
-Move Game::pawn_south_south_move(const Square origin_sq) const
+// Generates the pseudo-legal moves for a queen that belongs to the player
+// to move this turn to squares on the target bitboard and adds them to the
+// move list.
+void Game::pseudo_legal_queen_moves(
+        Move_list &moves,
+        const Square square,
+        const Bitboard targets
+) const
 {
-    const auto dest_sq = south_of(south_of(origin_sq));
+    // Look up the attack bitboard in the slider attack tables.
+    Bitboard attack_bitboard = bishop_attacks(square, all_pieces()) |
+                               rook_attacks(square, all_pieces());
 
-    // If the pawn is on the 7th row (meaning it has not moved yet), generate
-    // the 2-squares-south move as long as both squares south of the pawn are
-    // not occupied.
-    if (on_bitboard(origin_sq, row_7) && !is_occupied(south_of(origin_sq)) &&
-        !is_occupied(dest_sq))
-    {
-        return create_normal_move(origin_sq, dest_sq);
-    }
-    else
-    {
-        return Move::none;
-    }
+    // Only keep the target squares.
+    attack_bitboard &= targets;
+
+    gen_moves_from_bitboard(moves, square, attack_bitboard);
 }
 
 
-// Generates the pawn north-east capture move using the origin square.
-// Returns Move::none if the move would not be pseudo-legal.
-Move Game::pawn_north_east_move(const Square origin_sq) const
+// Generates the castling moves for a player in which the king does not pass
+// through or end up on an attacked square, and adds them to the move list.
+// The king is assumed to not be in check.
+template <Color color>
+void Game::legal_castling_moves(
+        Move_list &moves,
+        const Square king_sq
+) const
 {
-    const auto dest_sq = find_dest_square(
-            origin_sq,
-            {Direction::north, Direction::east}
-    );
+    const unsigned first_path = color == Color::white ? 0 : 2;
 
-    // If the square north east of the pawn's square is within the boundaries
-    // of the board and is occupied by a black piece, generate an attack move
-    // to that square.
-    if (dest_sq != Square::none &&
-        is_occupied(dest_sq, Color::black))
-    {
-        return create_normal_move(origin_sq, dest_sq);
-    }
-    else
+    // The squares attacked by the other player are only found if a castling
+    // move is possible, and only once for both castling moves.
+    Bitboard attacked = 0;
+    bool attacked_found = false;
+
+    for (auto i = first_path; i < first_path + 2; i++)
     {
-        return Move::none;
-    }
-}
+        const Castling_path &path = castling_paths[i];
 
+        if (!castling_path_clear(path))
+        {
+            continue;
+        }
 
-// Generates the pawn south-east capture move using the origin square.
-// Returns Move::none if the move would not be pseudo-legal.
-Move Game::pawn_south_east_move(const Square origin_sq) const
-{
-    const auto dest_sq = find_dest_square(
-            origin_sq,
-            {Direction::south, Direction::east}
-    );
+        if (!attacked_found)
+        {
+            attacked = attacked_squares<reverse_color(color)>(all_pieces());
+            attacked_found = true;
+        }
 
-    // If the square south east of the pawn's square is within the boundaries
-    // of the board and is occupied by a white piece, generate an attack move
-    // to that square.
-    if (dest_sq != Square::none &&
-        is_occupied(dest_sq, Color::white))
-    {
-        return create_normal_move(origin_sq, dest_sq);
-    }
-    else
-    {
-        return Move::none;
+        if (!on_bitboard(attacked, path.safe_squares))
+        {
+            moves.push_back(create_castling_move(king_sq, path.king_dest_sq));
+        }
     }
 }
 
 
-// Generates the pawn north-west capture move using the origin square.
-// Returns Move::none if the move would not be pseudo-legal.
-Move Game::pawn_north_west_move(const Square origin_sq) const
+// Generates the en passant moves for a player that do not leave their king
+// in check, and adds them to the move list.
+template <Color color>
+void Game::legal_en_passant_moves(
+        Move_list &moves,
+        const Square king_sq
+) const
 {
-    const auto dest_sq = find_dest_square(
-            origin_sq,
-            {Direction::north, Direction::west}
-    );
+    const Bitboard enemy_bitboard = pieces_of(reverse_color(color));
 
-    // If the square north west of the pawn's square is within the boundaries
-    // of the board and is occupied by a black piece, generate an attack move
-    // to that square.
-    if (dest_sq != Square::none &&
-        is_occupied(dest_sq, Color::black))
-    {
-        return create_normal_move(origin_sq, dest_sq);
-    }
-    else
+    Move_list en_passant_moves;
+    pseudo_legal_en_passant_moves<color>(en_passant_moves);
+
+    // En passant removes two pawns from the same row at once, which can
+    // expose the king in ways pins do not cover. Check each move directly by
+    // looking for attacks on the king after it has been made.
+    for (const auto move : en_passant_moves)
     {
-        return Move::none;
-    }
-}
+        const Square dest_sq = extract_dest_sq(move);
 
+        Piece enemy_pawn;
+        Square enemy_pawn_sq;
 
-// Generates the pawn south-west capture move using the origin square.
-// Returns Move::none if the move would not be pseudo-legal.
-Move Game::pawn_south_west_move(const Square origin_sq) const
-{
-    const auto dest_sq = find_dest_square(
-            origin_sq,
-            {Direction::south, Direction::west}
-    );
+        find_enemy_pawn_ep(enemy_pawn, enemy_pawn_sq, dest_sq, color);
 
-    // If the square south west of the pawn's square is within the boundaries
-    // of the board and is occupied by a white piece, generate an attack move
-    // to that square.
-    if (dest_sq != Square::none &&
-        is_occupied(dest_sq, Color::white))
-    {
-        return create_normal_move(origin_sq, dest_sq);
-    }
-    else
-    {
-        return Move::none;
+        const Bitboard enemy_pawn_bb = square_to_bb(enemy_pawn_sq);
+        const Bitboard occupancy = (all_pieces() ^
+                                    square_to_bb(extract_origin_sq(move)) ^
+                                    enemy_pawn_bb) |
+                                   square_to_bb(dest_sq);
+
+        if (!on_bitboard(attackers_to(king_sq, occupancy),
+                         enemy_bitboard & ~enemy_pawn_bb))
+        {
+            moves.push_back(move);
+        }
     }
 }
 
 
-// Generates the pawn north-east en passant move using the origin square.
-// Returns Move::none if the move would not be pseudo-legal.
-Move Game::pawn_ep_north_east_move(const Square origin_sq) const
+// Generates the legal moves of the specified kind for a player and adds
+// them to the move list. The pieces giving check and the pinned pieces of
+// the position are used so that only moves that do not leave the king in
+// check are generated.
+template <Color color>
+void Game::legal_moves(Move_list &moves, const Gen_type gen_type) const
 {
-    const auto dest_sq = find_dest_square(
-            origin_sq,
-            {Direction::north, Direction::east}
-    );
+    const Bitboard own_bitboard = pieces_of(color);
+    const Bitboard enemy_bitboard = pieces_of(reverse_color(color));
+    const Bitboard own_pawns = pieces_of(color, Piece_type::pawn);
 
-    // If the square north east of the pawn is within the boundaries of the
-    // board and is the en passant square, generate the en passant move.
-    if (dest_sq != Square::none && dest_sq == en_passant_square)
-    {
-        return create_en_passant_move(origin_sq, dest_sq);
-    }
-    else
+    // All moves go to squares without a friendly piece, captures go to
+    // squares with enemy pieces and quiet moves go to empty squares. Pawns
+    // also promote in the capture stage, even without a capture.
+    const Bitboard promo_row = color == Color::white ? row_8 : row_1;
+    Bitboard stage_targets = ~own_bitboard;
+    Bitboard pawn_stage_targets = ~own_bitboard;
+
+    switch (gen_type)
     {
-        return Move::none;
+        case Gen_type::captures:
+            stage_targets = enemy_bitboard;
+            pawn_stage_targets = enemy_bitboard | (promo_row & ~all_pieces());
+            break;
+        case Gen_type::quiets:
+            stage_targets = ~all_pieces();
+            pawn_stage_targets = ~all_pieces() & ~promo_row;
+            break;
+        case Gen_type::all:
+            break;
     }
-}
 
+    const Square king_sq = king_square<color>();
+    const Bitboard king_bb = square_to_bb(king_sq);
+    const Bitboard checkers = check_info.checkers;
 
-// Generates the pawn south-east en passant move using the origin square.
-// Returns Move::none if the move would not be pseudo-legal.
-Move Game::pawn_ep_south_east_move(const Square origin_sq) const
-{
-    const auto dest_sq = find_dest_square(
-            origin_sq,
-            {Direction::south, Direction::east}
-    );
+    // The king can move to any square that is not attacked. It is removed
+    // from the board first so that it does not block the attack of a slider
+    // on the squares behind it.
+    Bitboard king_dest_squares = king_attacks[static_cast<unsigned>(king_sq)] &
+                                 stage_targets;
 
-    // If the square south east of the pawn is within the boundaries of the
-    // board and is the en passant square, generate the en passant move.
-    if (dest_sq != Square::none && dest_sq == en_passant_square)
+    while (king_dest_squares != 0)
     {
-        return create_en_passant_move(origin_sq, dest_sq);
+        const Square dest_sq = pop_lsb(king_dest_squares);
+
+        if (!on_bitboard(attackers_to(dest_sq, all_pieces() ^ king_bb),
+                         enemy_bitboard))
+        {
+            moves.push_back(create_normal_move(king_sq, dest_sq));
+        }
     }
-    else
+
+    // In double check, only the king can move.
+    if (count_bits_set(checkers) > 1)
     {
-        return Move::none;
+        return;
     }
-}
 
+    // In check, the other pieces have to capture the checking piece or block
+    // it.
+    Bitboard evasion_targets = ~static_cast<Bitboard>(0);
 
-// Generates the pawn north-west en passant move using the origin square.
-// Returns Move::none if the move would not be pseudo-legal.
-Move Game::pawn_ep_north_west_move(const Square origin_sq) const
-{
-    const auto dest_sq = find_dest_square(
-            origin_sq,
-            {Direction::north, Direction::west}
-    );
-
-    // If the square north west of the pawn is within the boundaries of the
-    // board and is the en passant square, generate the en passant move.
-    if (dest_sq != Square::none && dest_sq == en_passant_square)
+    if (checkers != 0)
     {
-        return create_en_passant_move(origin_sq, dest_sq);
+        const auto checker_sq = static_cast<Square>(set_bit_pos(checkers));
+        evasion_targets = squares_between(king_sq, checker_sq) | checkers;
     }
-    else
+    // Castling out of check is not allowed.
+    else if (gen_type != Gen_type::captures)
     {
-        return Move::none;
+        legal_castling_moves<color>(moves, king_sq);
     }
-}
 
+    const Bitboard targets = stage_targets & evasion_targets;
+    const Bitboard pawn_targets = pawn_stage_targets & evasion_targets;
 
-// Generates the pawn south-west en passant move using the origin square.
-// Returns Move::none if the move would not be pseudo-legal.
-Move Game::pawn_ep_south_west_move(const Square origin_sq) const
-{
-    const auto dest_sq = find_dest_square(
-            origin_sq,
-            {Direction::south, Direction::west}
-    );
-
-    // If the square south west of the pawn is within the boundaries of the
-    // board and is the en passant square, generate the en passant move.
-    if (dest_sq != Square::none && dest_sq == en_passant_square)
-    {
-        return create_en_passant_move(origin_sq, dest_sq);
-    }
-    else
-    {
-        return Move::none;
-    }
-}
+    // Pinned pieces can only move along the line between their king and the
+    // piece pinning them.
+    const Bitboard pinned = check_info.pinned;
 
+    // Generate the moves for all the pawns that are not pinned at once and
+    // for each pinned pawn separately.
+    pseudo_legal_pawn_moves<color>(
+            moves,
+            own_pawns & ~pinned,
+            pawn_targets
+    );
 
-// Generates the 4 north-by-1 promotion moves using the origin square.
-// Returns Move::none if the moves would not be pseudo-legal.
-std::array<Move, 4> Game::pawn_promo_north_moves(
-        const Square origin_sq
-) const
-{
-    const auto dest_sq = north_of(origin_sq);
+    Bitboard pinned_pawns = own_pawns & pinned;
 
-    // If the pawn is on the 7th row and the square in front of it is not
-    // occupied, generate all non-capture promotion moves.
-    if (on_bitboard(origin_sq, row_7) && !is_occupied(dest_sq))
+    while (pinned_pawns != 0)
     {
-        return create_promo_moves(origin_sq, dest_sq);
+        const Square square = pop_lsb(pinned_pawns);
+
+        pseudo_legal_pawn_moves<color>(
+                moves,
+                square_to_bb(square),
+                pawn_targets & line_through(king_sq, square)
+        );
     }
-    else
+
+    if (gen_type != Gen_type::quiets)
     {
-        return {Move::none, Move::none, Move::none, Move::none};
+        legal_en_passant_moves<color>(moves, king_sq);
     }
-}
 
+    // Generate the moves for the remaining pieces.
+    Bitboard pieces = own_bitboard & ~own_pawns & ~king_bb;
 
-// Generates the 4 south-by-1 promotion moves using the origin square.
-// Returns Move::none if the moves would not be pseudo-legal.
-std::array<Move, 4> Game::pawn_promo_south_moves(
-        const Square origin_sq
-) const
-{
-    const auto dest_sq = south_of(origin_sq);
-
-    // If the pawn is on the 2nd row and the square in front of it is not
-    // occupied, generate all non-capture promotion moves.
-    if (on_bitboard(origin_sq, row_2) && !is_occupied(dest_sq))
+    while (pieces != 0)
     {
-        return create_promo_moves(origin_sq, dest_sq);
-    }
-    else
-    {
-        return {Move::none, Move::none, Move::none, Move::none};
-    }
-}
-
+        const Square square = pop_lsb(pieces);
+        Bitboard piece_targets = targets;
 
-// Generates the 4 north-east promotion capture moves using the origin
-// square. Returns Move::none if the moves would not be pseudo-legal.
-std::array<Move, 4> Game::pawn_promo_north_east_moves(
-        const Square origin_sq
-) const
-{
-    const auto dest_sq = north_of(east_of(origin_sq));
+        if (on_bitboard(square, pinned))
+        {
+            piece_targets &= line_through(king_sq, square);
+        }
 
-    // If the pawn is on the 7th row and is not on the H column and there
-    // is a black piece on the square north east of the pawn's square,
-    // generate all promotion attack moves to that square.
-    if (on_bitboard(origin_sq, row_7 & ~col_h) &&
-        is_occupied(dest_sq, Color::black))
-    {
-        return create_promo_moves(origin_sq, dest_sq);
-    }
-    else
-    {
-        return {Move::none, Move::none, Move::none, Move::none};
+        switch (piece_on(square))
+        {
+            case Piece::w_knight:
+            case Piece::b_knight:
+                pseudo_legal_knight_moves(moves, square, piece_targets);
+                break;
+            case Piece::w_bishop:
+            case Piece::b_bishop:
+                pseudo_legal_bishop_moves(moves, square, piece_targets);
+                break;
+            case Piece::w_rook:
+            case Piece::b_rook:
+                pseudo_legal_rook_moves(moves, square, piece_targets);
+                break;
+            case Piece::w_queen:
+            case Piece::b_queen:
+                pseudo_legal_queen_moves(moves, square, piece_targets);
+                break;
+            default:
+                break;
+        }
     }
 }
 
 
-// Generates the 4 south-east promotion capture moves using the origin
-// square. Returns Move::none if the moves would not be pseudo-legal.
-std::array<Move, 4> Game::pawn_promo_south_east_moves(
-        const Square origin_sq
-) const
+// Generates all legal moves for the current player.
+Move_list Game::legal_moves() const
 {
-    const auto dest_sq = south_of(east_of(origin_sq));
-
-    // If the pawn is on the 2nd row and is not on the H column and there
-    // is a white piece on the square south east of the pawn's square,
-    // generate all promotion attack moves to that square.
-    if (on_bitboard(origin_sq, row_2 & ~col_h) &&
-        is_occupied(dest_sq, Color::white))
-    {
-        return create_promo_moves(origin_sq, dest_sq);
-    }
-    else
-    {
-        return {Move::none, Move::none, Move::none, Move::none};
-    }
+    Move_list moves;
+    legal_moves(moves, Gen_type::all);
+    return moves;
 }
 
 
-// Generates the 4 north-west promotion capture moves using the origin
-// square. Returns Move::none if the moves would not be pseudo-legal.
-std::array<Move, 4> Game::pawn_promo_north_west_moves(
-        const Square origin_sq
-) const
+// Generates the legal moves of the specified kind for the current player and
+// adds them to the move list.
+void Game::legal_moves(Move_list &moves, const Gen_type gen_type) const
 {
-    const auto dest_sq = north_of(west_of(origin_sq));
-
-    // If the pawn is on the 7th row and is not on the A column and there is a
-    // black piece on the square north west of the pawn's square, generate all
-    // promotion attack moves to that square.
-    if (on_bitboard(origin_sq, row_7 & ~col_a) &&
-        is_occupied(dest_sq, Color::black))
+    if (position.turn == Color::white)
     {
-        return create_promo_moves(origin_sq, dest_sq);
+        legal_moves<Color::white>(moves, gen_type);
     }
     else
     {
-        return {Move::none, Move::none, Move::none, Move::none};
+        legal_moves<Color::black>(moves, gen_type);
     }
 }
 
 
-// Generates the 4 south-west promotion capture moves using the origin
-// square. Returns Move::none if the moves would not be pseudo-legal.
-std::array<Move, 4> Game::pawn_promo_south_west_moves(
-        const Square origin_sq
-) const
+// Checks if a move is legal for a player without generating the other moves.
+// The moving piece is checked against its attack table and the move is then
+// checked against the pieces giving check and the pins.
+template <Color color>
+bool Game::is_valid_move(const Move move) const
 {
-    const auto dest_sq = south_of(west_of(origin_sq));
+    const Bitboard own_bitboard = pieces_of(color);
+    const Bitboard enemy_bitboard = pieces_of(reverse_color(color));
+    const Bitboard own_pawns = pieces_of(color, Piece_type::pawn);
+    const Bitboard double_push_row = color == Color::white ? row_3 : row_6;
+    const Bitboard promo_row = color == Color::white ? row_8 : row_1;
+
+    const Square origin_sq = extract_origin_sq(move);
+    const Square dest_sq = extract_dest_sq(move);
+    const Move_type move_type = extract_move_type(move);
+    const Bitboard origin_bb = square_to_bb(origin_sq);
+    const Bitboard dest_bb = square_to_bb(dest_sq);
+    const Square king_sq = king_square<color>();
 
-    // If the pawn is on the 2nd row and is not on the A column and there is a
-    // white piece on the square south west of the pawn's square, generate all
-    // promotion attack moves to that square.
-    if (on_bitboard(origin_sq, row_2 & ~col_a) &&
-        is_occupied(dest_sq, Color::white))
+    // The moving piece has to belong to the player and cannot capture
+    // another one of their pieces.
+    if (!on_bitboard(origin_bb, own_bitboard) ||
+        on_bitboard(dest_bb, own_bitboard))
     {
-        return create_promo_moves(origin_sq, dest_sq);
+        return false;
     }
-    else
+
+    // There are at most two castling and two en passant moves, so those
+    // moves are checked by generating the legal moves of their kind.
+    if (move_type == Move_type::castling ||
+        move_type == Move_type::en_passant)
     {
-        return {Move::none, Move::none, Move::none, Move::none};
-    }
-}
+        Move_list moves;
 
+        if (move_type == Move_type::en_passant)
+        {
+            legal_en_passant_moves<color>(moves, king_sq);
+        }
+        // Castling out of check is not allowed.
+        else if (!in_check())
+        {
+            legal_castling_moves<color>(moves, king_sq);
+        }
 
-// Generates the white kingside castling move as long as it has not been
-// invalidated and no pieces are blocking it.
-Move Game::white_kingside_castle_move(const Square origin_sq) const
-{
-    // Make sure castling has not been invalidated and no pieces are blocking
-    // it.
-    if (!w_kingside_castling_invalidated() && !is_occupied(Square::F1) &&
-        !is_occupied(Square::G1))
-    {
-        return create_castling_move(origin_sq, Square::G1);
+        return std::find(moves.begin(), moves.end(), move) != moves.end();
     }
-    else
-    {
-        return Move::none;
-    }
-}
 
+    // Only pawns promote, and they always do when they reach the last row.
+    const bool is_pawn = on_bitboard(origin_bb, own_pawns);
 
-// Generates the white queenside castling move as long as it has not been
-// invalidated and no pieces are blocking it.
-Move Game::white_queenside_castle_move(const Square origin_sq) const
-{
-    // Make sure castling has not been invalidated and no pieces are blocking
-    // it.
-    if (!w_queenside_castling_invalidated() && !is_occupied(Square::D1) &&
-        !is_occupied(Square::C1) && !is_occupied(Square::B1))
+    if (move_type == Move_type::promotion)
     {
-        return create_castling_move(origin_sq, Square::C1);
+        if (!is_pawn || !on_bitboard(dest_bb, promo_row))
+        {
+            return false;
+        }
     }
-    else
+    else if (move != create_normal_move(origin_sq, dest_sq) ||
+             (is_pawn && on_bitboard(dest_bb, promo_row)))
     {
-        return Move::none;
+        return false;
     }
-}
 
+    // Find the squares the piece can move to.
+    Bitboard dest_squares;
 
-// Generates the black kingside castling move as long as it has not been
-// invalidated and no pieces are blocking it.
-Move Game::black_kingside_castle_move(const Square origin_sq) const
-{
-    // Make sure castling has not been invalidated and no pieces are blocking
-    // it.
-    if (!b_kingside_castling_invalidated() && !is_occupied(Square::F8) &&
-        !is_occupied(Square::G8))
+    if (is_pawn)
     {
-        return create_castling_move(origin_sq, Square::G8);
+        const Bitboard single_push = shift_forward<color>(origin_bb) &
+                                     ~all_pieces();
+
+        dest_squares = single_push |
+                       (shift_forward<color>(single_push & double_push_row) &
+                        ~all_pieces()) |
+                       ((shift_forward_east<color>(origin_bb) |
+                         shift_forward_west<color>(origin_bb)) &
+                        enemy_bitboard);
     }
     else
     {
-        return Move::none;
+        switch (piece_on(origin_sq))
+        {
+            case Piece::w_knight:
+            case Piece::b_knight:
+                dest_squares = knight_attacks[static_cast<unsigned>(
+                        origin_sq
+                )];
+                break;
+            case Piece::w_bishop:
+            case Piece::b_bishop:
+                dest_squares = bishop_attacks(origin_sq, all_pieces());
+                break;
+            case Piece::w_rook:
+            case Piece::b_rook:
+                dest_squares = rook_attacks(origin_sq, all_pieces());
+                break;
+            case Piece::w_queen:
+            case Piece::b_queen:
+                dest_squares = bishop_attacks(origin_sq, all_pieces()) |
+                               rook_attacks(origin_sq, all_pieces());
+                break;
+            default:
+                dest_squares = king_attacks[static_cast<unsigned>(
+                        origin_sq
+                )];
+                break;
+        }
     }
-}
-
 
-// Generates the black queenside castling move as long as it has not been
-// invalidated and no pieces are blocking it.
-Move Game::black_queenside_castle_move(const Square origin_sq) const
-{
-    // Make sure castling has not been invalidated and no pieces are blocking
-    // it.
-    if (!b_queenside_castling_invalidated() && !is_occupied(Square::D8) &&
-        !is_occupied(Square::C8) && !is_occupied(Square::B8))
+    if (!on_bitboard(dest_bb, dest_squares))
     {
-        return create_castling_move(origin_sq, Square::C8);
+        return false;
     }
-    else
+
+    // The king cannot move to an attacked square. It is removed from the
+    // board first so that it does not block the attack of a slider on the
+    // squares behind it.
+    if (origin_sq == king_sq)
     {
-        return Move::none;
+        return !on_bitboard(attackers_to(dest_sq, all_pieces() ^ origin_bb),
+                            enemy_bitboard);
     }
-}
-
 
-// Generates all pseudo-legal moves for a white pawn that belongs to the
-// player to move this turn.
-std::vector<Move> Game::pseudo_legal_w_pawn_moves(const Square square) const
-{
-    std::vector<Move> possible_moves;
-
-    // Generate non-capture moves.
-    possible_moves.push_back(pawn_north_move(square));
-    possible_moves.push_back(pawn_north_north_move(square));
-
-    // Generate capture moves.
-    possible_moves.push_back(pawn_north_east_move(square));
-    possible_moves.push_back(pawn_north_west_move(square));
-
-    // Generate en passant moves.
-    possible_moves.push_back(pawn_ep_north_east_move(square));
-    possible_moves.push_back(pawn_ep_north_west_move(square));
+    // In check, the other pieces have to capture the checking piece or block
+    // it. In double check, only the king can move.
+    const Bitboard checkers = check_info.checkers;
 
-    // Generate non-capture promotion moves.
-    const auto promo_north = pawn_promo_north_moves(square);
-
-    possible_moves.insert(
-            possible_moves.end(),
-            promo_north.begin(),
-            promo_north.end()
-    );
-
-    // Generate capture promotion moves.
-    const auto promo_north_east = pawn_promo_north_east_moves(square);
-
-    possible_moves.insert(
-            possible_moves.end(),
-            promo_north_east.begin(),
-            promo_north_east.end()
-    );
-
-    const auto promo_north_west = pawn_promo_north_west_moves(square);
-
-    possible_moves.insert(
-            possible_moves.end(),
-            promo_north_west.begin(),
-            promo_north_west.end()
-    );
-
-    // Remove invalid moves.
-    possible_moves.erase(
-            std::remove(
-                    possible_moves.begin(),
-                    possible_moves.end(),
-                    Move::none
-            ),
-            possible_moves.end()
-    );
-
-    return possible_moves;
-}
-
-
-// Generates all pseudo-legal moves for a black pawn that belongs to the
-// player to move this turn.
-std::vector<Move> Game::pseudo_legal_b_pawn_moves(const Square square) const
-{
-    std::vector<Move> possible_moves;
-
-    // Generate non-capture moves.
-    possible_moves.push_back(pawn_south_move(square));
-    possible_moves.push_back(pawn_south_south_move(square));
-
-    // Generate capture moves.
-    possible_moves.push_back(pawn_south_east_move(square));
-    possible_moves.push_back(pawn_south_west_move(square));
-
-    // Generate en passant moves.
-    possible_moves.push_back(pawn_ep_south_east_move(square));
-    possible_moves.push_back(pawn_ep_south_west_move(square));
-
-    // Generate non-capture promotion moves.
-    const auto promo_south = pawn_promo_south_moves(square);
-
-    possible_moves.insert(
-            possible_moves.end(),
-            promo_south.begin(),
-            promo_south.end()
-    );
-
-    // Generate capture promotion moves.
-    const auto promo_south_east = pawn_promo_south_east_moves(square);
-
-    possible_moves.insert(
-            possible_moves.end(),
-            promo_south_east.begin(),
-            promo_south_east.end()
-    );
-
-    const auto promo_south_west = pawn_promo_south_west_moves(square);
-
-    possible_moves.insert(
-            possible_moves.end(),
-            promo_south_west.begin(),
-            promo_south_west.end()
-    );
-
-    // Remove invalid moves.
-    possible_moves.erase(
-            std::remove(
-                    possible_moves.begin(),
-                    possible_moves.end(),
-                    Move::none
-            ),
-            possible_moves.end()
-    );
-
-    return possible_moves;
-}
-
-
-// Generates all pseudo-legal knight moves for a knight that belongs to the
-// player to move this turn.
-std::vector<Move> Game::pseudo_legal_knight_moves(const Square square) const
-{
-    std::vector<Move> possible_moves;
-
-    // North North East
-    possible_moves.push_back(pseudo_legal_normal_move(
-            square,
-            {Direction::north, Direction::north, Direction::east}
-    ));
-
-    // North North West
-    possible_moves.push_back(pseudo_legal_normal_move(
-            square,
-            {Direction::north, Direction::north, Direction::west}
-    ));
-
-    // North East East
-    possible_moves.push_back(pseudo_legal_normal_move(
-            square,
-            {Direction::north, Direction::east, Direction::east}
-    ));
-
-    // North West West
-    possible_moves.push_back(pseudo_legal_normal_move(
-            square,
-            {Direction::north, Direction::west, Direction::west}
-    ));
-
-    // South South East
-    possible_moves.push_back(pseudo_legal_normal_move(
-            square,
-            {Direction::south, Direction::south, Direction::east}
-    ));
-
-    // South South West
-    possible_moves.push_back(pseudo_legal_normal_move(
-            square,
-            {Direction::south, Direction::south, Direction::west}
-    ));
-
-    // South East East
-    possible_moves.push_back(pseudo_legal_normal_move(
-            square,
-            {Direction::south, Direction::east, Direction::east}
-    ));
-
-    // South West West
-    possible_moves.push_back(pseudo_legal_normal_move(
-            square,
-            {Direction::south, Direction::west, Direction::west}
-    ));
-
-    // Remove invalid moves.
-    possible_moves.erase(
-            std::remove(
-                    possible_moves.begin(),
-                    possible_moves.end(),
-                    Move::none
-            ),
-            possible_moves.end()
-    );
-
-    return possible_moves;
-}
-
-
-// Generates all pseudo-legal bishop moves for a bishop that belongs to the
-// player to move this turn.
-std::vector<Move> Game::pseudo_legal_bishop_moves(const Square square) const
-{
-    // Use magic bitboards to generate the attack bitboard.
-    Bitboard attack_bitboard = Bmagic(
-            static_cast<unsigned>(square),
-            all_bitboard
-    );
-
-    // Discard self-captures.
-    attack_bitboard = discard_self_captures(attack_bitboard);
-
-    return gen_moves_from_bitboard(square, attack_bitboard);
-}
-
-
-// Generates all pseudo-legal rook moves for a rook that belongs to the
-// player to move this turn. Castling does not count as a rook move.
-std::vector<Move> Game::pseudo_legal_rook_moves(const Square square) const
-{
-    // Use magic bitboards to generate the attack bitboard.
-    Bitboard attack_bitboard = Rmagic(
-            static_cast<unsigned>(square),
-            all_bitboard
-    );
-
-    // Discard self-captures.
-    attack_bitboard = discard_self_captures(attack_bitboard);
-
-    return gen_moves_from_bitboard(square, attack_bitboard);
-}
-
-
-// Generates all pseudo-legal queen moves for a queen that belongs to the
-// player to move this turn.
-std::vector<Move> Game::pseudo_legal_queen_moves(const Square square) const
-{
-    // Use magic bitboards to generate the attack bitboard.
-    Bitboard bishop_attack_bitboard = Bmagic(
-            static_cast<unsigned>(square),
-            all_bitboard
-    );
-
-    Bitboard rook_attack_bitboard = Rmagic(
-            static_cast<unsigned>(square),
-            all_bitboard
-    );
+    if (checkers != 0)
+    {
+        if (count_bits_set(checkers) > 1)
+        {
+            return false;
+        }
 
-    auto attack_bitboard = bishop_attack_bitboard | rook_attack_bitboard;
+        const auto checker_sq = static_cast<Square>(set_bit_pos(checkers));
 
-    // Discard self-captures.
-    attack_bitboard = discard_self_captures(attack_bitboard);
+        if (!on_bitboard(dest_bb,
+                         squares_between(king_sq, checker_sq) | checkers))
+        {
+            return false;
+        }
+    }
 
-    return gen_moves_from_bitboard(square, attack_bitboard);
+    // A pinned piece can only move along the line between its king and the
+    // piece pinning it.
+    return on_bitboard(dest_bb, line_through(king_sq, origin_sq)) ||
+           !on_bitboard(origin_bb, check_info.pinned);
 }
 
 
-// Generates all pseudo-legal king moves for the king that belongs to the
-// player to move this turn.
-std::vector<Move> Game::pseudo_legal_king_moves(const Square square) const
+// Checks if a move is legal for the current player without generating the
+// other moves.
+bool Game::is_valid_move(const Move move) const
 {
-    std::vector<Move> possible_moves;
-
-    // Normal moves
-
-    // North
-    possible_moves.push_back(pseudo_legal_normal_move(
-            square,
-            {Direction::north}
-    ));
-
-    // North East
-    possible_moves.push_back(pseudo_legal_normal_move(
-            square,
-            {Direction::north, Direction::east}
-    ));
-
-    // East
-    possible_moves.push_back(pseudo_legal_normal_move(
-            square,
-            {Direction::east}
-    ));
-
-    // South East
-    possible_moves.push_back(pseudo_legal_normal_move(
-            square,
-            {Direction::south, Direction::east}
-    ));
-
-    // South
-    possible_moves.push_back(pseudo_legal_normal_move(
-            square,
-            {Direction::south}
-    ));
-
-    // South West
-    possible_moves.push_back(pseudo_legal_normal_move(
-            square,
-            {Direction::south, Direction::west}
-    ));
-
-    // West
-    possible_moves.push_back(pseudo_legal_normal_move(
-            square,
-            {Direction::west}
-    ));
-
-    // North West
-    possible_moves.push_back(pseudo_legal_normal_move(
-            square,
-            {Direction::north, Direction::west}
-    ));
-
-    // Castling moves
-
-    if (turn == Color::white)
+    if (position.turn == Color::white)
     {
-        possible_moves.push_back(white_kingside_castle_move(square));
-        possible_moves.push_back(white_queenside_castle_move(square));
+        return is_valid_move<Color::white>(move);
     }
     else
     {
-        possible_moves.push_back(black_kingside_castle_move(square));
-        possible_moves.push_back(black_queenside_castle_move(square));
+        return is_valid_move<Color::black>(move);
     }
-
-    // Remove invalid moves.
-    possible_moves.erase(
-            std::remove(
-                    possible_moves.begin(),
-                    possible_moves.end(),
-                    Move::none
-            ),
-            possible_moves.end()
-    );
-
-    return possible_moves;
 }
@@ -0,0 +1,93 @@
+#ifndef DISCORD_CHESS_BOT_MOVE_LIST_H
+#define DISCORD_CHESS_BOT_MOVE_LIST_H
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include "types.h"
+
+
+// A move and its ordering score packed into 32 bits, so that a list of moves
+// being sorted takes half the memory it would with a separate array of
+// scores.
+struct Scored_move
+{
+    Move move;
+    std::int16_t score;
+};
+
+static_assert(sizeof(Scored_move) == 4,
+              "A scored move should be packed into 32 bits.");
+
+// The maximum number of moves a move list can hold. No chess position has
+// more than 218 legal moves, so 256 leaves room for pseudo-legal moves too.
+const unsigned max_moves = 256;
+
+// A fixed-capacity list of moves. It lives on the stack, so generating moves
+// for a position does not require any heap allocations.
+class Move_list
+{
+private:
+    // The moves are left uninitialized until they are added.
+    std::array<Move, max_moves> moves;
+
+    // Number of moves in the list.
+    unsigned count = 0;
+public:
+    // Adds a move to the end of the list. The list must not be full.
+    void push_back(const Move move)
+    {
+        assert(count < max_moves);
+        moves[count++] = move;
+    }
+
+    // Returns the number of moves in the list.
+    unsigned size() const
+    {
+        return count;
+    }
+
+    // Checks if the list has no moves.
+    bool empty() const
+    {
+        return count == 0;
+    }
+
+    // Removes all the moves from the list.
+    void clear()
+    {
+        count = 0;
+    }
+
+    Move &operator[](const unsigned index)
+    {
+        return moves[index];
+    }
+
+    Move operator[](const unsigned index) const
+    {
+        return moves[index];
+    }
+
+    Move *begin()
+    {
+        return moves.data();
+    }
+
+    Move *end()
+    {
+        return moves.data() + count;
+    }
+
+    const Move *begin() const
+    {
+        return moves.data();
+    }
+
+    const Move *end() const
+    {
+        return moves.data() + count;
+    }
+};
+
+#endif  //DISCORD_CHESS_BOT_MOVE_LIST_H
@@ -0,0 +1,188 @@
+#include <array>
+#include <cstdint>
+#include <utility>
+#include "types.h"
+#include "utils.h"
+#include "game.h"
+#include "move_picker.h"
+
+
+// Values of the pieces used to order captures, indexed by piece type. The
+// king is given the highest value so that capturing with it is tried last.
+const std::array<int, 13> piece_values =
+{
+    0,
+    1, 3, 3, 5, 9, 10,
+    1, 3, 3, 5, 9, 10
+};
+
+
+// Creates a move picker for the current position of a game.
+Move_picker::Move_picker(
+        const Game &game,
+        const Move hash_move,
+        const std::array<Move, 2> &killers
+) : game(game), hash_move(hash_move), killers(killers)
+{
+}
+
+
+// Scores each capture in the move list by the value of the captured piece
+// and the piece making the capture, and stores them with their scores.
+void Move_picker::score_captures()
+{
+    for (unsigned i = 0; i < moves.size(); i++)
+    {
+        const Move move = moves[i];
+        const Piece moved_piece = game.piece_on(extract_origin_sq(move));
+        const Move_type move_type = extract_move_type(move);
+
+        int victim_value = piece_values[
+                static_cast<unsigned>(game.piece_on(extract_dest_sq(move)))
+        ];
+
+        // En passant always captures a pawn, which is not on the destination
+        // square.
+        if (move_type == Move_type::en_passant)
+        {
+            victim_value = piece_values[static_cast<unsigned>(Piece::w_pawn)];
+        }
+        // A promotion gains the value of the promotion piece minus the pawn.
+        else if (move_type == Move_type::promotion)
+        {
+            const Piece promo_piece = promo_piece_to_piece(
+                    extract_promo_piece(move),
+                    game.position.turn
+            );
+            victim_value += piece_values[static_cast<unsigned>(promo_piece)] -
+                            piece_values[static_cast<unsigned>(moved_piece)];
+        }
+
+        // The most valuable victim is tried first. Among captures of the same
+        // victim, the least valuable attacker is tried first.
+        const int score = victim_value * 16 -
+                          piece_values[static_cast<unsigned>(moved_piece)];
+
+        scored_moves[i] = {move, static_cast<std::int16_t>(score)};
+    }
+}
+
+
+// Checks if a move has already been returned by the hash move or killer
+// stage.
+bool Move_picker::already_picked(const Move move) const
+{
+    return move == hash_move || move == killers[0] || move == killers[1];
+}
+
+
+// Returns the move with the highest score that has not been returned yet and
+// moves it to the current index. Returns Move::none if all the moves of the
+// current stage have been returned.
+Move Move_picker::pick_best()
+{
+    if (index >= moves.size())
+    {
+        return Move::none;
+    }
+
+    // Only the next move is sorted, so a cutoff leaves the rest unsorted.
+    unsigned best_index = index;
+
+    for (unsigned i = index + 1; i < moves.size(); i++)
+    {
+        if (scored_moves[i].score > scored_moves[best_index].score)
+        {
+            best_index = i;
+        }
+    }
+
+    std::swap(scored_moves[index], scored_moves[best_index]);
+
+    return scored_moves[index++].move;
+}
+
+
+// Returns the next legal move to search, or Move::none if there are no moves
+// left.
+Move Move_picker::next_move()
+{
+    Move move;
+
+    switch (stage)
+    {
+        case Pick_stage::hash_move:
+            stage = Pick_stage::gen_captures;
+
+            // The hash move comes from another position if its hash collided
+            // with this one, so make sure it is legal here.
+            if (hash_move != Move::none && game.is_valid_move(hash_move))
+            {
+                return hash_move;
+            }
+            [[fallthrough]];
+
+        case Pick_stage::gen_captures:
+            game.legal_moves(moves, Gen_type::captures);
+            score_captures();
+            stage = Pick_stage::captures;
+            [[fallthrough]];
+
+        case Pick_stage::captures:
+            while ((move = pick_best()) != Move::none)
+            {
+                // The hash move has already been returned.
+                if (move != hash_move)
+                {
+                    return move;
+                }
+            }
+            index = 0;
+            stage = Pick_stage::killers;
+            [[fallthrough]];
+
+        case Pick_stage::killers:
+            while (index < killers.size())
+            {
+                move = killers[index++];
+
+                // The killer moves come from sibling positions, so make sure
+                // they are legal quiet moves here. Captures have already been
+                // returned.
+                if (move != Move::none && move != hash_move &&
+                    game.is_quiet(move) && game.is_valid_move(move))
+                {
+                    return move;
+                }
+            }
+            stage = Pick_stage::gen_quiets;
+            [[fallthrough]];
+
+        case Pick_stage::gen_quiets:
+            moves.clear();
+            index = 0;
+            game.legal_moves(moves, Gen_type::quiets);
+            stage = Pick_stage::quiets;
+            [[fallthrough]];
+
+        case Pick_stage::quiets:
+            // The quiet moves are not ordered, so they are returned in the
+            // order they were generated.
+            while (index < moves.size())
+            {
+                move = moves[index++];
+
+                if (!already_picked(move))
+                {
+                    return move;
+                }
+            }
+            stage = Pick_stage::done;
+            [[fallthrough]];
+
+        case Pick_stage::done:
+            break;
+    }
+
+    return Move::none;
+}
@@ -0,0 +1,79 @@
+#ifndef DISCORD_CHESS_BOT_MOVE_PICKER_H
+#define DISCORD_CHESS_BOT_MOVE_PICKER_H
+
+#include <array>
+#include "types.h"
+#include "move_list.h"
+#include "game.h"
+
+
+// The stages a move picker goes through, in order.
+enum class Pick_stage
+{
+    hash_move,
+    gen_captures,
+    captures,
+    killers,
+    gen_quiets,
+    quiets,
+    done
+};
+
+// Returns the legal moves of a position one at a time, best first. The moves
+// are generated in stages: the hash move, then captures and promotions in
+// order of the most valuable victim and least valuable attacker, then the
+// killer moves, then the other quiet moves. A stage is only generated once all
+// the moves of the earlier stages have been returned, so a beta cutoff on an
+// early move does not pay for generating the later ones.
+class Move_picker
+{
+private:
+    const Game &game;
+
+    Pick_stage stage = Pick_stage::hash_move;
+
+    // The best move found for this position by an earlier search, or
+    // Move::none if there is none.
+    const Move hash_move;
+
+    // Quiet moves that caused a beta cutoff in a sibling position.
+    const std::array<Move, 2> killers;
+
+    // The moves of the current stage.
+    Move_list moves;
+
+    // The captures and their scores, so that sorting them swaps a single
+    // 32-bit entry.
+    std::array<Scored_move, max_moves> scored_moves;
+
+    // Index of the next move to return from the current stage. In the killer
+    // stage, this is the index of the next killer move.
+    unsigned index = 0;
+
+    // Scores each capture in the move list by the value of the captured
+    // piece and the piece making the capture, and stores them with their
+    // scores.
+    void score_captures();
+
+    // Checks if a move has already been returned by the hash move or killer
+    // stage.
+    bool already_picked(const Move move) const;
+
+    // Returns the move with the highest score that has not been returned yet
+    // and moves it to the current index. Returns Move::none if all the moves
+    // of the current stage have been returned.
+    Move pick_best();
+public:
+    // Creates a move picker for the current position of a game.
+    Move_picker(
+            const Game &game,
+            const Move hash_move,
+            const std::array<Move, 2> &killers
+    );
+
+    // Returns the next legal move to search, or Move::none if there are no
+    // moves left.
+    Move next_move();
+};
+
+#endif  //DISCORD_CHESS_BOT_MOVE_PICKER_H
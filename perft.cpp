@@ -0,0 +1,209 @@
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "types.h"
+#include "game.h"
+#include "perft_table.h"
+
+
+// Counts the leaf nodes of the tree of legal moves of the current position
+// up to the specified depth, which must be at least 1. The moves of the last
+// ply are counted without being made. If a table is passed, the counts of
+// positions that were already visited at the same depth are looked up in it.
+// The moves are taken back as the mode specifies.
+unsigned long long Game::perft_nodes(
+        const int depth,
+        Perft_table *table,
+        const Make_mode mode
+)
+{
+    Move_list moves;
+    legal_moves(moves, Gen_type::all);
+
+    if (depth == 1)
+    {
+        return moves.size();
+    }
+
+    const Bitstring key = hash();
+    unsigned long long nodes = 0;
+
+    if (table != nullptr && table->probe(key, depth, nodes))
+    {
+        return nodes;
+    }
+
+    for (const auto move : moves)
+    {
+        if (mode == Make_mode::copy_make)
+        {
+            // Restoring the copies takes back the move.
+            const Position parent = position;
+            const Check_info parent_check_info = check_info;
+            play_move(move);
+            nodes += perft_nodes(depth - 1, table, mode);
+            position = parent;
+            check_info = parent_check_info;
+        }
+        else
+        {
+            make_legal_move(move);
+            nodes += perft_nodes(depth - 1, table, mode);
+            undo();
+        }
+    }
+
+    if (table != nullptr)
+    {
+        table->store(key, depth, nodes);
+    }
+
+    return nodes;
+}
+
+
+// Counts the leaf nodes below each of the root moves up to the specified
+// depth, which must be at least 1. The root moves are split among a pool of
+// threads that each search their own copy of the game.
+std::vector<unsigned long long> Game::perft_root(
+        const Move_list &moves,
+        const int depth,
+        const unsigned threads,
+        Perft_table *table,
+        const Make_mode mode
+) const
+{
+    std::vector<unsigned long long> counts(moves.size());
+
+    // Index of the next root move that has not been taken by a thread yet.
+    std::atomic<unsigned> next_move(0);
+
+    auto worker = [&]()
+    {
+        Game game = *this;
+        unsigned index;
+
+        while ((index = next_move++) < moves.size())
+        {
+            if (depth == 1)
+            {
+                counts[index] = 1;
+                continue;
+            }
+
+            game.make_legal_move(moves[index]);
+            counts[index] = game.perft_nodes(depth - 1, table, mode);
+            game.undo();
+        }
+    };
+
+    // The calling thread is one of the threads of the pool.
+    std::vector<std::thread> pool;
+
+    for (unsigned i = 1; i < threads; i++)
+    {
+        pool.emplace_back(worker);
+    }
+
+    worker();
+
+    for (auto &thread : pool)
+    {
+        thread.join();
+    }
+
+    return counts;
+}
+
+
+// Counts the leaf nodes of the tree of legal moves of the current position
+// up to the specified depth. The root moves are split among the specified
+// number of threads. If the hash table size in megabytes is not 0, the
+// counts of positions that were already visited are looked up in a table of
+// that size, which is shared by the threads. The moves are taken back as the
+// mode specifies.
+unsigned long long Game::perft(
+        const int depth,
+        const unsigned threads,
+        const unsigned hash_mb,
+        const Make_mode mode
+) const
+{
+    if (depth <= 0)
+    {
+        return 1;
+    }
+
+    std::unique_ptr<Perft_table> table;
+
+    if (hash_mb != 0)
+    {
+        table.reset(new Perft_table(hash_mb));
+    }
+
+    const Move_list moves = legal_moves();
+    const std::vector<unsigned long long> counts = perft_root(
+            moves,
+            depth,
+            threads,
+            table.get(),
+            mode
+    );
+    unsigned long long nodes = 0;
+
+    for (const auto count : counts)
+    {
+        nodes += count;
+    }
+
+    return nodes;
+}
+
+
+// Returns the number of leaf nodes below each legal move of the current
+// position up to the specified depth, one move per line, followed by the
+// total. The threads and hash table size are used like they are in perft().
+// Example line: "e2e4: 20"
+std::string Game::divide(
+        const int depth,
+        const unsigned threads,
+        const unsigned hash_mb
+) const
+{
+    std::string result;
+
+    if (depth <= 0)
+    {
+        return "\nNodes: 1\n";
+    }
+
+    std::unique_ptr<Perft_table> table;
+
+    if (hash_mb != 0)
+    {
+        table.reset(new Perft_table(hash_mb));
+    }
+
+    const Move_list moves = legal_moves();
+    const std::vector<unsigned long long> counts = perft_root(
+            moves,
+            depth,
+            threads,
+            table.get(),
+            Make_mode::make_undo
+    );
+    unsigned long long nodes = 0;
+
+    for (unsigned i = 0; i < moves.size(); i++)
+    {
+        result += move_to_string(moves[i]) + ": " +
+                  std::to_string(counts[i]) + "\n";
+        nodes += counts[i];
+    }
+
+    result += "\nNodes: " + std::to_string(nodes) + "\n";
+
+    return result;
+}
@@ -0,0 +1,88 @@
+#ifndef DISCORD_CHESS_BOT_PERFT_TABLE_H
+#define DISCORD_CHESS_BOT_PERFT_TABLE_H
+
+#include <atomic>
+#include <vector>
+#include "types.h"
+
+
+// A hash table of perft results keyed by the Zobrist hash of a position and
+// the remaining depth. It can be shared by several threads without locks.
+// Each entry stores its key XORed with its data, so an entry that was
+// written by two threads at once fails the key check instead of returning a
+// wrong count.
+class Perft_table
+{
+private:
+    struct Entry
+    {
+        // The key XORed with the data.
+        std::atomic<Bitstring> check;
+
+        // The node count shifted left by 8 bits with the depth in the least
+        // significant 8 bits.
+        std::atomic<unsigned long long> data;
+    };
+
+    // The number of entries is a power of two so that the index can be
+    // computed with a mask.
+    std::vector<Entry> entries;
+    Bitstring index_mask;
+public:
+    // Creates a table that uses at most the specified number of megabytes.
+    explicit Perft_table(const unsigned size_mb)
+    {
+        unsigned long long size = 1;
+
+        while (size * 2 * sizeof(Entry) <=
+               static_cast<unsigned long long>(size_mb) << 20)
+        {
+            size *= 2;
+        }
+
+        entries = std::vector<Entry>(size);
+        index_mask = size - 1;
+    }
+
+    // Looks up the node count of a position at the specified depth. Returns
+    // false if it is not in the table.
+    bool probe(
+            const Bitstring key,
+            const int depth,
+            unsigned long long &nodes
+    ) const
+    {
+        const Entry &entry = entries[key & index_mask];
+        const unsigned long long data = entry.data.load(
+                std::memory_order_relaxed
+        );
+        const Bitstring check = entry.check.load(std::memory_order_relaxed);
+
+        if ((check ^ data) != key ||
+            (data & 0xFF) != static_cast<unsigned long long>(depth))
+        {
+            return false;
+        }
+
+        nodes = data >> 8;
+        return true;
+    }
+
+    // Saves the node count of a position at the specified depth, replacing
+    // the entry the key maps to.
+    void store(
+            const Bitstring key,
+            const int depth,
+            const unsigned long long nodes
+    )
+    {
+        Entry &entry = entries[key & index_mask];
+        const unsigned long long data = (nodes << 8) |
+                                        static_cast<unsigned long long>(depth);
+
+        entry.check.store(key ^ data, std::memory_order_relaxed);
+        entry.data.store(data, std::memory_order_relaxed);
+    }
+};
+
+#endif  //DISCORD_CHESS_BOT_PERFT_TABLE_H
@@ -0,0 +1,104 @@
+#ifndef DISCORD_CHESS_BOT_POSITION_H
+#define DISCORD_CHESS_BOT_POSITION_H
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+#include "types.h"
+
+
+// The state of the board, without the history of the game. This is a plain
+// struct of fixed size so that it can be copied with a single memcpy, which
+// lets a search save a position before making a move and restore it instead
+// of undoing the move.
+struct Position
+{
+    // Bitboards of each player's pieces of each type, indexed by color (see
+    // color_index()) and piece type.
+    std::array<std::array<Bitboard, 6>, 2> piece_bitboards;
+
+    // Occupancy bitboards of each player, indexed by color.
+    std::array<Bitboard, 2> color_bitboards;
+
+    // Zobrist key of the position, including the player to move, castling
+    // rights and en passant square. It is updated with every change to the
+    // position.
+    Bitstring key;
+
+    // The piece on each square, or none if the square is empty.
+    std::array<Piece, 64> pieces_on_board;
+
+    // The evaluation of the board calculated using piece-square tables.
+    std::int16_t evaluation;
+
+    // Number of plies that have elapsed since a pawn was moved or a piece was
+    // captured. Used for the 50-move rule.
+    std::uint16_t rule50;
+
+    // The square a pawn would end up if it performed en passant.
+    // If the last move was not a 2-square pawn move, the value of this is none.
+    Square en_passant_square;
+
+    // Only the least significant 4 bits are used.
+    // Bit 0: white kingside castle
+    // Bit 1: white queenside castle
+    // Bit 2: black kingside castle
+    // Bit 3: black queenside castle
+    // Bits that are turned on represent castles that have not yet been
+    // permanently invalidated.
+    Castling_right castling_rights;
+
+    // The color of the player who is to play this turn.
+    Color turn;
+};
+
+static_assert(std::is_trivially_copyable<Position>::value,
+              "A position should be copyable with memcpy.");
+static_assert(sizeof(Position) <= 192,
+              "A position should fit in 3 cache lines.");
+
+// The initial position of a game. The hash and evaluation are computed when
+// a game is created.
+constexpr Position start_position =
+{
+    {{
+        {
+            0xFF00,
+            0x0042,
+            0x0024,
+            0x0081,
+            0x0008,
+            0x0010
+        },
+        {
+            0x00FF000000000000,
+            0x4200000000000000,
+            0x2400000000000000,
+            0x8100000000000000,
+            0x0800000000000000,
+            0x1000000000000000
+        }
+    }},
+    {
+        0x000000000000FFFF,
+        0xFFFF000000000000
+    },
+    0,
+    {
+        Piece::w_rook, Piece::w_knight, Piece::w_bishop, Piece::w_queen, Piece::w_king, Piece::w_bishop, Piece::w_knight, Piece::w_rook,
+        Piece::w_pawn,   Piece::w_pawn,   Piece::w_pawn,  Piece::w_pawn, Piece::w_pawn,   Piece::w_pawn,   Piece::w_pawn, Piece::w_pawn,
+          Piece::none,     Piece::none,     Piece::none,    Piece::none,   Piece::none,     Piece::none,     Piece::none,   Piece::none,
+          Piece::none,     Piece::none,     Piece::none,    Piece::none,   Piece::none,     Piece::none,     Piece::none,   Piece::none,
+          Piece::none,     Piece::none,     Piece::none,    Piece::none,   Piece::none,     Piece::none,     Piece::none,   Piece::none,
+          Piece::none,     Piece::none,     Piece::none,    Piece::none,   Piece::none,     Piece::none,     Piece::none,   Piece::none,
+        Piece::b_pawn,   Piece::b_pawn,   Piece::b_pawn,  Piece::b_pawn, Piece::b_pawn,   Piece::b_pawn,   Piece::b_pawn, Piece::b_pawn,
+        Piece::b_rook, Piece::b_knight, Piece::b_bishop, Piece::b_queen, Piece::b_king, Piece::b_bishop, Piece::b_knight, Piece::b_rook
+    },
+    0,
+    0,
+    Square::none,
+    Castling_right::all_castling,
+    Color::white
+};
+
+#endif  //DISCORD_CHESS_BOT_POSITION_H
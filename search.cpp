@@ -1,27 +1,34 @@
-#include <vector>
 #include <algorithm>
 #include "types.h"
+#include "utils.h"
 #include "game.h"
+#include "move_picker.h"
 
 
 const int infinity = 9999999;
 
 
 // Search function used for the root ply. It uses minimax and alpha-beta
-// pruning to return the best legal move for the current position.
-Move Game::best_move(const int depth)
+// pruning to return the best legal move for the current position. The moves
+// are taken back as the mode specifies.
+Move Game::best_move(const int depth, const Make_mode mode)
 {
-    const std::vector<Move> possible_moves = pseudo_legal_moves();
+    Move_picker picker(*this, Move::none, {Move::none, Move::none});
 
     Move best_move;
 
+    nodes = 0;
+
+    // Killer moves from a previous search are not useful for this one.
+    killers.assign(depth + 1, {Move::none, Move::none});
+
     int best_eval;
 
     bool is_maximizing;
 
     // White wants to maximize the evaluation. Black does not. Start out at
     // the worst evaluation so that another move is picked as the best move.
-    if (turn == Color::white)
+    if (position.turn == Color::white)
     {
         is_maximizing = true;
         best_eval = -infinity;
@@ -33,15 +40,17 @@ Move Game::best_move(const int depth)
     }
 
     // Go through all the moves and pick the one with the best evaluation.
-    for (const auto move : possible_moves)
+    Move move;
+    while ((move = picker.next_move()) != Move::none)
     {
-        // Make the move. If it is illegal, skip it.
-        if (!make_move(move))
-        {
-            continue;
-        }
-        const int eval = minimax(depth, -infinity, infinity, !is_maximizing);
-        undo();
+        const int eval = search_move(
+                move,
+                depth,
+                -infinity,
+                infinity,
+                !is_maximizing,
+                mode
+        );
 
         // Update the best evaluation if the evaluation of this move is the
         // new best.
@@ -69,52 +78,63 @@ Move Game::best_move(const int depth)
 
 // The recursive function that returns the best evaluation found for a
 // ply. It utilizes minimax with alpha-beta pruning. This will not be
-// used for the root ply.
-int Game::minimax(int depth, int alpha, int beta, bool is_maximizing)
+// used for the root ply. The moves are taken back as the mode specifies.
+int Game::minimax(
+        int depth,
+        int alpha,
+        int beta,
+        bool is_maximizing,
+        const Make_mode mode
+)
 {
-    const std::vector<Move> possible_moves = pseudo_legal_moves();
+    nodes++;
 
-    const Game_state state = game_state(possible_moves);
+    // A position that repeats an earlier one is scored as a draw on its
+    // first repetition. If repeating it were good for either player, that
+    // player could repeat it again. A drawn position only needs its full list
+    // of moves to rule out a checkmate or stalemate, which take precedence.
+    const Game_state draw = draw_state(1);
 
-    // A checkmate should be counted as an evaluation of infinity for White or
-    // an evaluation of -infinity for Black, as it is the best position for
-    // the player making the checkmate and the worst for their opponent.
-    // A tie should have an evaluation of 0, it should only be forced if the
-    // bot is at a disadvantage.
-    switch (state)
+    if (draw != Game_state::in_progress)
     {
-        case Game_state::in_progress:
-            break;
-        case Game_state::checkmate_by_white:
-            return infinity;
-        case Game_state::checkmate_by_black:
-            return -infinity;
-        case Game_state::stalemate:
-        case Game_state::threefold_repetition:
-        case Game_state::fifty_move:
-        case Game_state::insufficient_material:
-            return 0;
+        const Move_list moves = legal_moves();
+
+        return eval_game_state(moves.empty() ? game_state(moves) : draw);
     }
 
-    // Going deeper would be too time-consuming. Evaluate the board instead.
+    // Going deeper would be too time-consuming. Evaluate the board instead,
+    // unless the game has ended.
     if (depth == 0)
     {
-        return evaluate();
+        return eval_game_state(game_state());
+    }
+
+    // The moves are generated lazily, so a beta cutoff on an early move skips
+    // generating the later stages.
+    Move_picker picker(*this, Move::none, killers[depth]);
+    Move move;
+
+    // If there are no legal moves, the game has ended in a checkmate or
+    // stalemate.
+    if ((move = picker.next_move()) == Move::none)
+    {
+        return eval_game_state(game_state(Move_list()));
     }
 
     if (is_maximizing)
     {
         int best_eval = -infinity;
         // Go through every move to pick the one with the best evaluation.
-        for (auto const move : possible_moves)
+        do
         {
-            // Make the move. If it is illegal, skip it.
-            if (!make_move(move))
-            {
-                continue;
-            }
-            const int eval = minimax(depth - 1, alpha, beta, false);
-            undo();
+            const int eval = search_move(
+                    move,
+                    depth - 1,
+                    alpha,
+                    beta,
+                    false,
+                    mode
+            );
 
             best_eval = std::max(best_eval, eval);
 
@@ -124,10 +144,11 @@ int Game::minimax(int depth, int alpha, int beta, bool is_maximizing)
             alpha = std::max(alpha, best_eval);
             if (beta <= alpha)
             {
+                store_killer(move, depth);
                 return best_eval;
             }
 
-        }
+        } while ((move = picker.next_move()) != Move::none);
 
         return best_eval;
     }
@@ -135,15 +156,16 @@ int Game::minimax(int depth, int alpha, int beta, bool is_maximizing)
     {
         int best_eval = infinity;
         // Go through every move to pick the one with the best evaluation.
-        for (auto const move : possible_moves)
+        do
         {
-            // Make the move. If it is illegal, skip it.
-            if (!make_move(move))
-            {
-                continue;
-            }
-            const int eval = minimax(depth - 1, alpha, beta, true);
-            undo();
+            const int eval = search_move(
+                    move,
+                    depth - 1,
+                    alpha,
+                    beta,
+                    true,
+                    mode
+            );
 
             best_eval = std::min(best_eval, eval);
 
@@ -153,11 +175,112 @@ int Game::minimax(int depth, int alpha, int beta, bool is_maximizing)
             beta = std::min(beta, best_eval);
             if (beta <= alpha)
             {
+                store_killer(move, depth);
                 return best_eval;
             }
-        }
+        } while ((move = picker.next_move()) != Move::none);
 
         return best_eval;
     }
 
 }
+
+
+// Makes a move, returns the evaluation that minimax() finds for the position
+// after it and takes the move back as the mode specifies.
+int Game::search_move(
+        const Move move,
+        const int depth,
+        const int alpha,
+        const int beta,
+        const bool is_maximizing,
+        const Make_mode mode
+)
+{
+    if (mode == Make_mode::copy_make)
+    {
+        // The ply data is still saved so that repetitions are detected from
+        // the history, but restoring the copies takes back the move.
+        const Position parent = position;
+        const Check_info parent_check_info = check_info;
+        make_legal_move(move);
+
+        const int eval = minimax(depth, alpha, beta, is_maximizing, mode);
+
+        position = parent;
+        check_info = parent_check_info;
+        plies_from_null = history.back().plies_from_null;
+        history.pop_back();
+
+        return eval;
+    }
+
+    make_legal_move(move);
+    const int eval = minimax(depth, alpha, beta, is_maximizing, mode);
+    undo();
+
+    return eval;
+}
+
+
+// Returns the evaluation of a position with the specified game state. A game
+// that is still in progress is evaluated using evaluate().
+int Game::eval_game_state(const Game_state state) const
+{
+    // A checkmate should be counted as an evaluation of infinity for White or
+    // an evaluation of -infinity for Black, as it is the best position for
+    // the player making the checkmate and the worst for their opponent.
+    // A tie should have an evaluation of 0, it should only be forced if the
+    // bot is at a disadvantage.
+    switch (state)
+    {
+        case Game_state::in_progress:
+            break;
+        case Game_state::checkmate_by_white:
+            return infinity;
+        case Game_state::checkmate_by_black:
+            return -infinity;
+        case Game_state::stalemate:
+        case Game_state::threefold_repetition:
+        case Game_state::fifty_move:
+        case Game_state::insufficient_material:
+            return 0;
+    }
+
+    return evaluate();
+}
+
+
+// Saves a quiet move that caused a beta cutoff as a killer move for the
+// specified remaining depth.
+void Game::store_killer(const Move move, const int depth)
+{
+    // Captures and promotions are already tried early.
+    if (!is_quiet(move) || killers[depth][0] == move)
+    {
+        return;
+    }
+
+    // Keep the two most recent killer moves.
+    killers[depth][1] = killers[depth][0];
+    killers[depth][0] = move;
+}
+
+
+// Checks if a move is quiet, which means it is not a capture, en passant or
+// promotion.
+bool Game::is_quiet(const Move move) const
+{
+    const Move_type move_type = extract_move_type(move);
+
+    return !is_occupied(extract_dest_sq(move)) &&
+           move_type != Move_type::en_passant &&
+           move_type != Move_type::promotion;
+}
+
+
+// Gets the number of positions visited by the last search.
+unsigned long long Game::get_nodes() const
+{
+    return nodes;
+}
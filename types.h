@@ -1,6 +1,8 @@
 #ifndef DISCORD_CHESS_BOT_TYPES_H
 #define DISCORD_CHESS_BOT_TYPES_H
 
+#include <cstdint>
+
 
 // 64-bit bitboards will be used to represent the 64 squares of a chessboard
 // as per little-endian rank-file mapping.
@@ -8,7 +10,7 @@ typedef unsigned long long Bitboard;
 
 // A position on a bitboard can be represented using only 6 bits, storing
 // numbers from 0 to 63.
-enum class Square : int
+enum class Square : std::int8_t
 {
     A1, B1, C1, D1, E1, F1, G1, H1,
     A2, B2, C2, D2, E2, F2, G2, H2,
@@ -22,7 +24,8 @@ enum class Square : int
     none = -1
 };
 
-// A move needs exactly 2 bytes (16 bits), the minimum size an int can be.
+// A move needs exactly 2 bytes (16 bits), so it is stored in a 16-bit
+// integer.
 // Bits 0-5: position of the origin square
 // Bits 6-11: position of the destination square
 // Bits 12-13 promotion piece flag
@@ -42,7 +45,7 @@ enum class Square : int
 //
 // none is a special case because the origin square is always different from
 // the destination square, so it is guaranteed to never be a possible move.
-enum class Move : unsigned int
+enum class Move : std::uint16_t
 {
     none
 };
@@ -51,7 +54,7 @@ enum class Move : unsigned int
 // numbers that are 64 bits long.
 typedef unsigned long long Bitstring;
 
-enum class Piece
+enum class Piece : std::uint8_t
 {
     none,
     w_pawn,
@@ -68,6 +71,18 @@ enum class Piece
     b_king
 };
 
+// The kind of a piece regardless of its color. Used to index arrays of piece
+// bitboards.
+enum class Piece_type
+{
+    pawn,
+    knight,
+    bishop,
+    rook,
+    queen,
+    king
+};
+
 // Bits 12-13 of a move, so shifted left by 12 bits.
 enum class Promotion_piece : unsigned int
 {
@@ -88,7 +103,7 @@ enum class Move_type : unsigned int
 };
 
 // Each castling right is one bit.
-enum class Castling_right : unsigned int
+enum class Castling_right : std::uint8_t
 {
     no_castling,
     w_kingside,
@@ -100,7 +115,7 @@ enum class Castling_right : unsigned int
     all_castling = white | black
 };
 
-enum class Color
+enum class Color : std::uint8_t
 {
     none,
     white,
@@ -126,20 +141,54 @@ enum class Game_state
     insufficient_material
 };
 
+// The ways a search can take back the moves it makes.
+enum class Make_mode
+{
+    // Each move is undone using the ply data saved when it was made.
+    make_undo,
+
+    // The position is copied before each move and the copy is restored
+    // afterwards. Perft saves nothing to the history of the game, while
+    // search still saves the ply data so that repetitions are detected.
+    copy_make
+};
+
+// The kinds of moves a move generator can be asked for. Captures include en
+// passant and every promotion. Quiet moves are all the other moves.
+enum class Gen_type
+{
+    captures,
+    quiets,
+    all
+};
+
+// The pieces giving check to the player to move and that player's pieces
+// pinned to their king. Computed once per position and shared by move
+// generation, legality checks and game-end detection.
+struct Check_info
+{
+    Bitboard checkers;
+    Bitboard pinned;
+};
+
 // Stores information for a ply. Used to reverse moves.
 struct Ply_data
 {
+    // Before the move occurred. The key of the position k plies ago is at
+    // k entries from the end of the history, which is used to detect
+    // repetitions.
+    Bitstring key;
+
     // The move that ended this ply
     Move last_move;
     Piece captured_piece;
 
-    // After the move occurred
-    bool threefold_repetition;
-
     // Before the move occurred
     Castling_right castling_rights;
     Square en_passant_square;
-    int rule50;
+    std::uint16_t rule50;
+    unsigned plies_from_null;
+    Check_info check_info;
 };
 
 #endif  //DISCORD_CHESS_BOT_TYPES_H
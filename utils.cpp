@@ -1,29 +1,7 @@
-#include <vector>
-#include <random>
 #include "types.h"
 #include "utils.h"
 
 
-// Returns the opposite color. Returns none if the input is not white or
-// black.
-Color reverse_color(const Color color)
-{
-    // Return the opposite color.
-    if (color == Color::white)
-    {
-        return Color::black;
-    }
-    else if (color == Color::black)
-    {
-        return Color::white;
-    }
-    else
-    {
-        return Color::none;
-    }
-}
-
-
 // Creates a move.
 Move create_move(
         const Square origin_sq,
@@ -339,73 +317,75 @@ Piece promo_piece_to_piece(
 }
 
 
-// Generates a random bitstring.
-Bitstring rand_hash()
-{
-    // Use a Mersenne Twister pseudo-random generator to generate a random
-    // 64-bit number.
-    std::mt19937_64 generator (std::random_device{}());
-
-    return generator();
-}
-
-
-// Generates a vector of moves using a bitboard.
-std::vector<Move> gen_moves_from_bitboard(
+// Generates moves using a bitboard and adds them to the move list passed
+// as the first argument.
+void gen_moves_from_bitboard(
+        Move_list &moves,
         const Square origin_sq,
         Bitboard bitboard
 )
 {
-    std::vector<Move> moves;
-
     // Set the origin square.
     const auto template_move = set_origin_sq(Move::none, origin_sq);
 
     // Get the positions of the set bits in the bitboard and use them to
     // create moves.
-    for(auto position = 0; bitboard != 0; position++)
+    while (bitboard != 0)
     {
-        if ((bitboard & 1) == 1)
-        {
-            moves.push_back(set_dest_sq(
-                    template_move,
-                    static_cast<Square>(position)));
-        }
-        bitboard >>= 1;
+        moves.push_back(set_dest_sq(template_move, pop_lsb(bitboard)));
     }
-
-    return moves;
 }
 
 
-// Counts the number of set bits in a bitboard.
-int count_bits_set(Bitboard bitboard)
+// Generates moves using a bitboard of destination squares and adds them to
+// the move list passed as the first argument. The origin square of each move
+// is its destination square minus the offset, so this can generate the same
+// kind of move for all pawns at once.
+void gen_pawn_moves_from_bitboard(
+        Move_list &moves,
+        Bitboard bitboard,
+        const int offset,
+        const Move_type move_type
+)
 {
-    int i;
-
-    // This uses Brian Kernighan's algorithm.
-    // Clears the least significant set bit until all bits have been cleared.
-    for (i = 0; bitboard != 0; i++)
+    // Get the positions of the set bits in the bitboard and use them to
+    // create moves.
+    while (bitboard != 0)
     {
-        bitboard &= bitboard - 1;  // Clear the least significant set bit.
+        const auto position = static_cast<int>(pop_lsb(bitboard));
+
+        moves.push_back(create_move(
+                static_cast<Square>(position - offset),
+                static_cast<Square>(position),
+                Promotion_piece::none,
+                move_type));
     }
-    return i;
 }
 
 
-// Finds the position of the only set bit on a bitboard.
-int set_bit_pos(Bitboard bitboard)
+// Generates all 4 promotion moves for each destination square on a bitboard
+// and adds them to the move list passed as the first argument. The origin
+// square of each move is its destination square minus the offset.
+void gen_promo_moves_from_bitboard(
+        Move_list &moves,
+        Bitboard bitboard,
+        const int offset
+)
 {
-    int position = 0;
-
-    // Keep right shifting the bitboard by 1 bit until the first bit is set.
-    while ((bitboard & 1) == 0)
+    // Get the positions of the set bits in the bitboard and use them to
+    // create moves.
+    while (bitboard != 0)
     {
-        bitboard >>= 1;
-        position++;
-    }
+        const auto position = static_cast<int>(pop_lsb(bitboard));
+        const auto promo_moves = create_promo_moves(
+                static_cast<Square>(position - offset),
+                static_cast<Square>(position));
 
-    return position;
+        for (const auto move : promo_moves)
+        {
+            moves.push_back(move);
+        }
+    }
 }
 
 
@@ -444,6 +424,52 @@ Square west_of(const Square origin_sq)
 }
 
 
+// Shifts all the squares on a bitboard north by 1 square.
+Bitboard shift_north(const Bitboard bitboard)
+{
+    return bitboard << 8;
+}
+
+
+// Shifts all the squares on a bitboard south by 1 square.
+Bitboard shift_south(const Bitboard bitboard)
+{
+    return bitboard >> 8;
+}
+
+
+// Shifts all the squares on a bitboard north east by 1 square. Squares
+// that would wrap around to the A column are discarded.
+Bitboard shift_north_east(const Bitboard bitboard)
+{
+    return (bitboard & ~col_h) << 9;
+}
+
+
+// Shifts all the squares on a bitboard north west by 1 square. Squares
+// that would wrap around to the H column are discarded.
+Bitboard shift_north_west(const Bitboard bitboard)
+{
+    return (bitboard & ~col_a) << 7;
+}
+
+
+// Shifts all the squares on a bitboard south east by 1 square. Squares
+// that would wrap around to the A column are discarded.
+Bitboard shift_south_east(const Bitboard bitboard)
+{
+    return (bitboard & ~col_h) >> 7;
+}
+
+
+// Shifts all the squares on a bitboard south west by 1 square. Squares
+// that would wrap around to the H column are discarded.
+Bitboard shift_south_west(const Bitboard bitboard)
+{
+    return (bitboard & ~col_a) >> 9;
+}
+
+
 // Determines if a square is on a bitboard.
 bool on_bitboard(const Square square, const Bitboard bitboard)
 {
@@ -457,64 +483,3 @@ bool on_bitboard(const Bitboard bitboard1, const Bitboard bitboard2)
 {
     return (bitboard1 & bitboard2) != 0;
 }
-
-
-// Find the destination square using the origin square and a list of
-// directions. Returns Move::none if the destination square is outside
-// the boundaries.
-Square find_dest_square(
-        const Square origin_sq,
-        const std::vector<Direction> &directions
-)
-{
-    auto dest_sq = origin_sq;
-    const Bitboard origin_bb = square_to_bb(origin_sq);
-    unsigned north_count = 0;
-    unsigned east_count = 0;
-    unsigned south_count = 0;
-    unsigned west_count = 0;
-
-    // Keep track of each directional move of the square, making sure it does
-    // not exit the boundaries of the board. If it does not, then continue
-    // moving it until all the requested moves have been made.
-    for (const auto &direction : directions)
-    {
-        switch (direction)
-        {
-            case Direction::north:
-                if (on_bitboard(origin_bb, rows[7 - north_count]))
-                {
-                    return Square::none;
-                }
-                dest_sq = north_of(dest_sq);
-                north_count++;
-                break;
-            case Direction::east:
-                if (on_bitboard(origin_bb, cols[7 - east_count]))
-                {
-                    return Square::none;
-                }
-                dest_sq = east_of(dest_sq);
-                east_count++;
-                break;
-            case Direction::south:
-                if (on_bitboard(origin_bb, rows[south_count]))
-                {
-                    return Square::none;
-                }
-                dest_sq = south_of(dest_sq);
-                south_count++;
-                break;
-            case Direction::west:
-                if (on_bitboard(origin_bb, cols[west_count]))
-                {
-                    return Square::none;
-                }
-                dest_sq = west_of(dest_sq);
-                west_count++;
-                break;
-        }
-    }
-
-    return dest_sq;
-}
\ No newline at end of file
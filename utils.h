@@ -1,9 +1,10 @@
 #ifndef DISCORD_CHESS_BOT_UTILS_H
 #define DISCORD_CHESS_BOT_UTILS_H
 
-#include <vector>
 #include <array>
+#include <bit>
 #include "types.h"
+#include "move_list.h"
 
 
 const Bitboard white_squares = 0x55AA55AA55AA55AA;
@@ -53,7 +54,51 @@ const std::array<Bitboard, 8> cols =
 
 // Returns the opposite color. Returns none if the input is not white or
 // black.
-Color reverse_color(const Color color);
+constexpr Color reverse_color(const Color color)
+{
+    // Return the opposite color.
+    if (color == Color::white)
+    {
+        return Color::black;
+    }
+    else if (color == Color::black)
+    {
+        return Color::white;
+    }
+    else
+    {
+        return Color::none;
+    }
+}
+
+// Returns the index of a color in arrays indexed by color, which is 0 for
+// white and 1 for black. The color must not be none.
+constexpr unsigned color_index(const Color color)
+{
+    return static_cast<unsigned>(color) - 1;
+}
+
+// Returns the index of the color of a piece in arrays indexed by color. The
+// piece must not be none.
+constexpr unsigned piece_color_index(const Piece piece)
+{
+    return (static_cast<unsigned>(piece) - 1) / 6;
+}
+
+// Returns the index of the type of a piece in arrays indexed by piece type.
+// The piece must not be none.
+constexpr unsigned piece_type_index(const Piece piece)
+{
+    return (static_cast<unsigned>(piece) - 1) % 6;
+}
+
+// Creates a piece of the specified color and type.
+constexpr Piece make_piece(const Color color, const Piece_type type)
+{
+    return static_cast<Piece>(
+            color_index(color) * 6 + static_cast<unsigned>(type) + 1
+    );
+}
 
 // Creates a move.
 Move create_move(
@@ -133,20 +178,55 @@ Piece promo_piece_to_piece(
         const Color color
 );
 
-// Generates a random bitstring.
-Bitstring rand_hash();
-
-// Generates a vector of moves using a bitboard.
-std::vector<Move> gen_moves_from_bitboard(
+// Generates moves using a bitboard and adds them to the move list passed
+// as the first argument.
+void gen_moves_from_bitboard(
+        Move_list &moves,
         const Square origin_sq,
         Bitboard bitboard
 );
 
+// Generates moves using a bitboard of destination squares and adds them to
+// the move list passed as the first argument. The origin square of each move
+// is its destination square minus the offset, so this can generate the same
+// kind of move for all pawns at once.
+void gen_pawn_moves_from_bitboard(
+        Move_list &moves,
+        Bitboard bitboard,
+        const int offset,
+        const Move_type move_type
+);
+
+// Generates all 4 promotion moves for each destination square on a bitboard
+// and adds them to the move list passed as the first argument. The origin
+// square of each move is its destination square minus the offset.
+void gen_promo_moves_from_bitboard(
+        Move_list &moves,
+        Bitboard bitboard,
+        const int offset
+);
+
 // Counts the number of set bits in a bitboard.
-int count_bits_set(Bitboard bitboard);
+inline int count_bits_set(const Bitboard bitboard)
+{
+    return std::popcount(bitboard);
+}
 
-// Finds the position of the only set bit on a bitboard.
-int set_bit_pos(Bitboard bitboard);
+// Finds the position of the least significant set bit on a bitboard. The
+// bitboard must not be empty.
+inline int set_bit_pos(const Bitboard bitboard)
+{
+    return std::countr_zero(bitboard);
+}
+
+// Returns the square of the least significant set bit on a bitboard and
+// clears that bit. The bitboard must not be empty.
+inline Square pop_lsb(Bitboard &bitboard)
+{
+    const auto square = static_cast<Square>(std::countr_zero(bitboard));
+    bitboard &= bitboard - 1;
+    return square;
+}
 
 // Converts a square to a bitboard with a single bit turned on.
 Bitboard square_to_bb(const Square square);
@@ -163,6 +243,57 @@ Square east_of(const Square origin_sq);
 // Returns the square west of the origin square.
 Square west_of(const Square origin_sq);
 
+// Shifts all the squares on a bitboard north by 1 square.
+Bitboard shift_north(const Bitboard bitboard);
+
+// Shifts all the squares on a bitboard south by 1 square.
+Bitboard shift_south(const Bitboard bitboard);
+
+// Shifts all the squares on a bitboard north east by 1 square. Squares
+// that would wrap around to the A column are discarded.
+Bitboard shift_north_east(const Bitboard bitboard);
+
+// Shifts all the squares on a bitboard north west by 1 square. Squares
+// that would wrap around to the H column are discarded.
+Bitboard shift_north_west(const Bitboard bitboard);
+
+// Shifts all the squares on a bitboard south east by 1 square. Squares
+// that would wrap around to the A column are discarded.
+Bitboard shift_south_east(const Bitboard bitboard);
+
+// Shifts all the squares on a bitboard south west by 1 square. Squares
+// that would wrap around to the H column are discarded.
+Bitboard shift_south_west(const Bitboard bitboard);
+
+// Shifts all the squares on a bitboard 1 square towards the opponent of the
+// specified player.
+template <Color color>
+Bitboard shift_forward(const Bitboard bitboard)
+{
+    return color == Color::white ? shift_north(bitboard) :
+                                   shift_south(bitboard);
+}
+
+// Shifts all the squares on a bitboard 1 square towards the opponent of the
+// specified player and 1 square east. Squares that would wrap around to the
+// A column are discarded.
+template <Color color>
+Bitboard shift_forward_east(const Bitboard bitboard)
+{
+    return color == Color::white ? shift_north_east(bitboard) :
+                                   shift_south_east(bitboard);
+}
+
+// Shifts all the squares on a bitboard 1 square towards the opponent of the
+// specified player and 1 square west. Squares that would wrap around to the
+// H column are discarded.
+template <Color color>
+Bitboard shift_forward_west(const Bitboard bitboard)
+{
+    return color == Color::white ? shift_north_west(bitboard) :
+                                   shift_south_west(bitboard);
+}
+
 // Determines if a square is on a bitboard.
 bool on_bitboard(const Square square, const Bitboard bitboard);
 
@@ -170,12 +301,4 @@ bool on_bitboard(const Square square, const Bitboard bitboard);
 // bitboard.
 bool on_bitboard(const Bitboard bitboard1, const Bitboard bitboard2);
 
-// Find the destination square using the origin square and a list of
-// directions. Returns Move::none if the destination square is outside
-// the boundaries.
-Square find_dest_square(
-        const Square origin_sq,
-        const std::vector<Direction> &directions
-);
-
 #endif  //DISCORD_CHESS_BOT_UTILS_H
@@ -1,115 +1,134 @@
+#include <array>
 #include "types.h"
 #include "utils.h"
 #include "game.h"
 
 
-// Initializes the random bitstrings require for Zobrist hashing.
-void Game::init_zobrist()
+// The bitstrings used for Zobrist hashing.
+struct Zobrist_bitstrings
 {
-    // Initialize player to move bitstrings
-    white_bitstring = rand_hash();
-    black_bitstring = rand_hash();
+    // Bitstrings for each square/piece combination, indexed by color (see
+    // color_index()), piece type and square.
+    std::array<std::array<std::array<Bitstring, 64>, 6>, 2> pieces;
 
-    // Initialize bitstrings for each square
-    for (auto square_index = 0; square_index < 64; square_index++)
+    // Bitstring for black being the player to move. When white is to move,
+    // nothing is added to the key.
+    Bitstring black_to_move;
+
+    // Bitstrings for each possible combination of castling rights.
+    // 2 possible values ^ 4 castling rights = 16 combinations
+    std::array<Bitstring, 16> castling;
+
+    // Bitstrings for the en passant squares.
+    std::array<Bitstring, 64> en_passant;
+};
+
+
+// Returns the next number of a SplitMix64 sequence and advances its state.
+constexpr Bitstring split_mix(Bitstring &state)
+{
+    state += 0x9E3779B97F4A7C15;
+
+    Bitstring result = state;
+    result = (result ^ (result >> 30)) * 0xBF58476D1CE4E5B9;
+    result = (result ^ (result >> 27)) * 0x94D049BB133111EB;
+
+    return result ^ (result >> 31);
+}
+
+
+// Generates the bitstrings from a fixed seed. The bitstrings are the same in
+// every game and every process, so keys can be compared between them.
+constexpr Zobrist_bitstrings gen_zobrist_bitstrings()
+{
+    Zobrist_bitstrings bitstrings{};
+    Bitstring state = 0x2545F4914F6CDD1D;
+
+    for (auto &color_bitstrings : bitstrings.pieces)
     {
-        w_pawn_bitstrings[square_index] = rand_hash();
-        w_knight_bitstrings[square_index] = rand_hash();
-        w_bishop_bitstrings[square_index] = rand_hash();
-        w_rook_bitstrings[square_index] = rand_hash();
-        w_queen_bitstrings[square_index] = rand_hash();
-        w_king_bitstrings[square_index] = rand_hash();
-
-        en_passant_bitstrings[square_index] = rand_hash();
+        for (auto &type_bitstrings : color_bitstrings)
+        {
+            for (auto &bitstring : type_bitstrings)
+            {
+                bitstring = split_mix(state);
+            }
+        }
     }
 
-    // Initialize castling rights bitstrings
-    for (auto &castling_bitstring : castling_bitstrings)
+    bitstrings.black_to_move = split_mix(state);
+
+    for (auto &bitstring : bitstrings.castling)
     {
-        castling_bitstring = rand_hash();
+        bitstring = split_mix(state);
     }
+
+    for (auto &bitstring : bitstrings.en_passant)
+    {
+        bitstring = split_mix(state);
+    }
+
+    return bitstrings;
 }
 
+constexpr auto zobrist_bitstrings = gen_zobrist_bitstrings();
+
 
-// Initializes the Zobrist hash for the piece positions.
+// Computes the Zobrist key of the position from scratch.
 void Game::init_hash()
 {
-    position_hash = 0;
+    position.key = position.turn == Color::white ? 0 : hash_black_to_move();
+    position.key ^= hash_castling(position.castling_rights);
+    position.key ^= hash_en_passant(position.en_passant_square);
 
-    // XOR the hash of each square.
-    for (auto square_index = 0; square_index < 64; square_index++)
+    // XOR the hash of each occupied square.
+    Bitboard occupied = all_pieces();
+
+    while (occupied != 0)
     {
-        position_hash ^= hash_square(static_cast<Square>(square_index));
+        const Square square = pop_lsb(occupied);
+        position.key ^= hash_piece(piece_on(square), square);
     }
 }
 
 
-// Returns the bitstring for a square.
-Bitstring Game::hash_square(Square square) const
+// Returns the bitstring of a piece on a square. The piece must not be none.
+Bitstring Game::hash_piece(const Piece piece, const Square square) const
 {
-
-    switch (piece_on(square))
-    {
-        case Piece::none:
-            return 0;
-
-        case Piece::w_pawn:
-            return w_pawn_bitstrings[static_cast<unsigned>(square)];
-        case Piece::w_knight:
-            return w_knight_bitstrings[static_cast<unsigned>(square)];
-        case Piece::w_bishop:
-            return w_bishop_bitstrings[static_cast<unsigned>(square)];
-        case Piece::w_rook:
-            return w_rook_bitstrings[static_cast<unsigned>(square)];
-        case Piece::w_queen:
-            return w_queen_bitstrings[static_cast<unsigned>(square)];
-        case Piece::w_king:
-            return w_king_bitstrings[static_cast<unsigned>(square)];
-
-        case Piece::b_pawn:
-            return b_pawn_bitstrings[static_cast<unsigned>(square)];
-        case Piece::b_knight:
-            return b_knight_bitstrings[static_cast<unsigned>(square)];
-        case Piece::b_bishop:
-            return b_bishop_bitstrings[static_cast<unsigned>(square)];
-        case Piece::b_rook:
-            return b_rook_bitstrings[static_cast<unsigned>(square)];
-        case Piece::b_queen:
-            return b_queen_bitstrings[static_cast<unsigned>(square)];
-        case Piece::b_king:
-            return b_king_bitstrings[static_cast<unsigned>(square)];
-    }
+    return zobrist_bitstrings.pieces[piece_color_index(piece)][
+            piece_type_index(piece)
+    ][static_cast<unsigned>(square)];
 }
 
 
-// Generates the Zobrist key for the current position.
-Bitstring Game::hash() const
+// Returns the bitstring that is in the key when black is to move.
+Bitstring Game::hash_black_to_move() const
 {
-    // The position hash is already calculated.
-    // XOR it with the turn, castling rights, and en passant square bitstrings
-    // to get the final hash.
-    auto hash_result = position_hash;
+    return zobrist_bitstrings.black_to_move;
+}
 
-    if (turn == Color::white)
-    {
-        hash_result ^= white_bitstring;
-    }
-    else
-    {
-        hash_result ^= black_bitstring;
-    }
 
-    hash_result ^= castling_bitstrings[static_cast<unsigned>(
-            castling_rights
-    )];
+// Returns the bitstring of a combination of castling rights.
+Bitstring Game::hash_castling(const Castling_right castling_rights) const
+{
+    return zobrist_bitstrings.castling[static_cast<unsigned>(castling_rights)];
+}
 
 
-    if (en_passant_square != Square::none)
+// Returns the bitstring of an en passant square, or 0 if the square is none.
+Bitstring Game::hash_en_passant(const Square square) const
+{
+    if (square == Square::none)
     {
-        hash_result ^= en_passant_bitstrings[static_cast<unsigned>(
-                en_passant_square
-        )];
+        return 0;
     }
 
-    return hash_result;
+    return zobrist_bitstrings.en_passant[static_cast<unsigned>(square)];
+}
+
+
+// Returns the Zobrist key of the current position. The key is kept up to
+// date as moves are made and undone.
+Bitstring Game::hash() const
+{
+    return position.key;
 }